@@ -0,0 +1,51 @@
+﻿#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Минимальный набор для микробенчмарков: функция замера регистрируется макросом BENCHMARK
+// и вызывается с числом итераций, которое подбирается так, чтобы замер длился не меньше
+// заданного времени. Результат выводится как среднее время одной итерации.
+
+using BenchFunction = void (*)(size_t iterations);
+
+struct BenchCase
+{
+    string name;
+    BenchFunction run;
+};
+
+vector<BenchCase>& benchRegistry();
+
+struct BenchRegistrar
+{
+    BenchRegistrar(const char* name, BenchFunction run) { benchRegistry().push_back({ name, run }); }
+};
+
+#define BENCHMARK(name) \
+    static void name(size_t iterations); \
+    static BenchRegistrar name##_registrar(#name, name); \
+    static void name(size_t iterations)
+
+// Не дает компилятору выбросить вычисления, результат которых не используется
+extern volatile double benchSink;
+
+inline void keepValue(double value) { benchSink = value; }
+
+// Число обработанных элементов (лексем, строк и т.п.) за одну итерацию;
+// если задано, кроме времени итерации выводится пропускная способность
+void setItemsPerIteration(double items);
+
+// Дополнительный счетчик на одну итерацию (например, число обращений к таблице);
+// выводится после времени и сохраняется в JSON как <name>_per_iteration
+void setCounter(const string& name, double perIteration);
+
+// Исключение подготовки данных из замера: время между pauseTiming и resumeTiming не учитывается
+void pauseTiming();
+void resumeTiming();
+
+// Размер входных данных, умноженный на коэффициент --scale (не меньше 1)
+size_t scaled(size_t size);
@@ -0,0 +1,53 @@
+﻿#include "bench.h"
+#include "tableManager.h"
+
+// Поиск существующих имен в хеш-таблицах на 10, 1K и 100K записей:
+// цепочки (THashTableChain, 10 корзин по умолчанию) против открытой адресации (THashTableOpen)
+
+namespace
+{
+    template <template <typename, typename> class THashTable, size_t Count>
+    struct TableFixture
+    {
+        THashTable<string, int> table;
+        vector<string> keys;
+
+        TableFixture()
+        {
+            for (size_t i = 0; i < Count; ++i)
+            {
+                keys.push_back("name" + to_string(i));
+                table.Insert(keys.back(), static_cast<int>(i), false);
+            }
+        }
+
+        static TableFixture& instance()
+        {
+            static TableFixture fixture;
+            return fixture;
+        }
+    };
+
+    template <template <typename, typename> class THashTable, size_t Count>
+    void lookupExisting(size_t iterations)
+    {
+        auto& f = TableFixture<THashTable, Count>::instance();
+        double sum = 0.0;
+        size_t index = 0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            sum += *f.table.Find(f.keys[index]);
+            index += 7919; // Обход ключей вразброс, а не в порядке вставки
+            if (index >= Count)
+                index %= Count;
+        }
+        keepValue(sum);
+    }
+
+    BenchRegistrar chain10("hash_chain_lookup_10", lookupExisting<THashTableChain, 10>);
+    BenchRegistrar open10("hash_open_lookup_10", lookupExisting<THashTableOpen, 10>);
+    BenchRegistrar chain1k("hash_chain_lookup_1k", lookupExisting<THashTableChain, 1000>);
+    BenchRegistrar open1k("hash_open_lookup_1k", lookupExisting<THashTableOpen, 1000>);
+    BenchRegistrar chain100k("hash_chain_lookup_100k", lookupExisting<THashTableChain, 100000>);
+    BenchRegistrar open100k("hash_open_lookup_100k", lookupExisting<THashTableOpen, 100000>);
+}
@@ -0,0 +1,99 @@
+﻿#include "bench.h"
+#include "input_source.h"
+#include "lexer.h"
+#include "parser.h"
+#include "program_executor.h"
+
+#include <sstream>
+
+// Чтение 1M чисел: operator>> потока (как Read читал раньше) против источников InputSource,
+// а также исполнение программы из 1M вызовов Read без приглашений (разбор исключен из замера)
+
+namespace
+{
+    const size_t ValueCount = 1000000;
+
+    const string& inputText()
+    {
+        static const string text = [] {
+            string result;
+            for (size_t i = 0; i < ValueCount; ++i)
+                result += to_string(i % 1000) + (i % 2 ? ".25\n" : " ");
+            return result;
+        }();
+        return text;
+    }
+
+    BENCHMARK(read_1m_values_istream)
+    {
+        double sum = 0.0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            istringstream in(inputText());
+            double value;
+            while (in >> value)
+                sum += value;
+        }
+        setItemsPerIteration(static_cast<double>(ValueCount));
+        keepValue(sum);
+    }
+
+    BENCHMARK(read_1m_values_stream_source)
+    {
+        double sum = 0.0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            istringstream in(inputText());
+            StreamInputSource source(in);
+            double value;
+            while (source.next(value))
+                sum += value;
+        }
+        setItemsPerIteration(static_cast<double>(ValueCount));
+        keepValue(sum);
+    }
+
+    BENCHMARK(read_1m_values_buffer_source)
+    {
+        double sum = 0.0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            BufferInputSource source(inputText());
+            double value;
+            while (source.next(value))
+                sum += value;
+        }
+        setItemsPerIteration(static_cast<double>(ValueCount));
+        keepValue(sum);
+    }
+
+    BENCHMARK(read_1m_calls_execute)
+    {
+        static const string program = [] {
+            string text = "program Reads;\nvar\n    x : integer;\n    y : double;\nbegin\n";
+            for (size_t i = 0; i < ValueCount; ++i)
+                text += i % 2 ? "    Read(y);\n" : "    Read(x);\n";
+            return text + "    Write(x, y);\nend.\n";
+        }();
+        ostringstream out;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            pauseTiming();
+            {
+                LexemeStream stream(program);
+                HLArena arena;
+                Parser parser;
+                HLNode* root = parser.BuildHList(stream, arena);
+                resumeTiming();
+                BufferInputSource input(inputText());
+                ProgramExecutor executor(out);
+                executor.setInput(input);
+                executor.setPrompts(false);
+                executor.Execute(root);
+                pauseTiming();
+            }
+            resumeTiming();
+        }
+        setItemsPerIteration(static_cast<double>(ValueCount));
+    }
+}
@@ -0,0 +1,176 @@
+﻿#include "bench.h"
+#include "lexer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+
+// Токенизация сгенерированной программы на несколько мегабайт: исходный лексер со строкой
+// на каждую лексему (копия ниже), Tokenize (TokenizeViews + ToLexeme) и TokenizeViews,
+// а также пропускная способность на тексте почти из одних ключевых слов и операторов
+
+namespace
+{
+    const size_t StatementCount = 100000;
+    const size_t VariableCount = 200;
+
+    const string& generatedSource()
+    {
+        static const string source = [] {
+            string text = "program Generated;\nconst\n    Limit = 1000;\nvar\n";
+            for (size_t v = 0; v < VariableCount; ++v)
+                text += "    Value" + to_string(v) + " : integer;\n";
+            text += "begin\n";
+            for (size_t i = 0; i < StatementCount; ++i)
+            {
+                string target = "Value" + to_string(i % VariableCount);
+                string operand = "Value" + to_string((i * 7) % VariableCount);
+                if (i % 10 == 0)
+                    text += "    if " + operand + " > Limit then\n        begin\n        Write(\"overflow\", " + operand + ");\n        end\n";
+                else
+                    text += "    " + target + " := (" + operand + " + " + to_string(i) + ") div 3 - " + target + " * 2.5;\n";
+            }
+            text += "end.\n";
+            return text;
+        }();
+        return source;
+    }
+
+    // Исходный лексер (до TokenizeViews): substr и поиск в std::map для каждой лексемы.
+    // Хранится здесь как эталон для сравнения, результат совпадает с Lexer::Tokenize.
+    const map<string, LexemeType>& referenceDatabase()
+    {
+        static const map<string, LexemeType> database = {
+            { "program", LexemeType::Keyword }, { "const", LexemeType::Keyword }, { "var", LexemeType::Keyword },
+            { "begin", LexemeType::Keyword }, { "end", LexemeType::Keyword }, { "if", LexemeType::Keyword },
+            { "then", LexemeType::Keyword }, { "else", LexemeType::Keyword }, { "read", LexemeType::Keyword },
+            { "write", LexemeType::Keyword }, { "div", LexemeType::Operator }, { "mod", LexemeType::Operator },
+            { "integer", LexemeType::VarType }, { "double", LexemeType::VarType },
+            { "+", LexemeType::Operator }, { "-", LexemeType::Operator }, { "*", LexemeType::Operator },
+            { "/", LexemeType::Operator }, { ":=", LexemeType::Operator }, { "=", LexemeType::Operator },
+            { "<>", LexemeType::Operator }, { "<", LexemeType::Operator }, { ">", LexemeType::Operator },
+            { "<=", LexemeType::Operator }, { ">=", LexemeType::Operator },
+            { "(", LexemeType::Separator }, { ")", LexemeType::Separator }, { ";", LexemeType::Separator },
+            { ".", LexemeType::Separator }, { ",", LexemeType::Separator }, { ":", LexemeType::Separator },
+        };
+        return database;
+    }
+
+    vector<Lexeme> referenceTokenize(const string& sourceCode)
+    {
+        const map<string, LexemeType>& database = referenceDatabase();
+        vector<Lexeme> result;
+        size_t i = 0;
+        while (i < sourceCode.size())
+        {
+            if (isspace(sourceCode[i]))
+            {
+                ++i;
+                continue;
+            }
+            if (sourceCode[i] == '"')
+            {
+                size_t valueStart = ++i;
+                while (i < sourceCode.size() && sourceCode[i] != '"')
+                    ++i;
+                result.push_back({ LexemeType::StringLiteral, sourceCode.substr(valueStart, i - valueStart) });
+                if (i < sourceCode.size())
+                    ++i;
+                continue;
+            }
+            if (isdigit(sourceCode[i]))
+            {
+                size_t start = i;
+                while (i < sourceCode.size() && (isdigit(sourceCode[i]) || sourceCode[i] == '.'))
+                    ++i;
+                result.push_back({ LexemeType::Number, sourceCode.substr(start, i - start) });
+                continue;
+            }
+            if (isalpha(sourceCode[i]) || sourceCode[i] == '_')
+            {
+                size_t start = i;
+                while (i < sourceCode.size() && (isalnum(sourceCode[i]) || sourceCode[i] == '_'))
+                    ++i;
+                string word = sourceCode.substr(start, i - start);
+                transform(word.begin(), word.end(), word.begin(), ::tolower);
+                auto it = database.find(word);
+                result.push_back({ it != database.end() ? it->second : LexemeType::Identifier, word });
+                continue;
+            }
+            if (i + 1 < sourceCode.size())
+            {
+                string twoChars = sourceCode.substr(i, 2);
+                auto it = database.find(twoChars);
+                if (it != database.end() && it->second != LexemeType::Keyword)
+                {
+                    result.push_back({ it->second, twoChars });
+                    i += 2;
+                    continue;
+                }
+            }
+            string oneChar(1, sourceCode[i]);
+            auto it = database.find(oneChar);
+            result.push_back({ it != database.end() ? it->second : LexemeType::Unknown, oneChar });
+            ++i;
+        }
+        result.push_back({ LexemeType::EndOfFile, "" });
+        return result;
+    }
+
+    BENCHMARK(lexer_reference_strings)
+    {
+        const string& source = generatedSource();
+        size_t count = 0;
+        for (size_t i = 0; i < iterations; ++i)
+            count += referenceTokenize(source).size();
+        keepValue(static_cast<double>(count));
+    }
+
+    BENCHMARK(lexer_tokenize_strings)
+    {
+        const string& source = generatedSource();
+        Lexer lexer;
+        size_t count = 0;
+        for (size_t i = 0; i < iterations; ++i)
+            count += lexer.Tokenize(source).size();
+        keepValue(static_cast<double>(count));
+    }
+
+    BENCHMARK(lexer_tokenize_views)
+    {
+        const string& source = generatedSource();
+        Lexer lexer;
+        size_t count = 0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            NamePool pool;
+            count += lexer.TokenizeViews(source, pool).size();
+        }
+        keepValue(static_cast<double>(count));
+    }
+
+    const string& keywordDenseSource()
+    {
+        static const string source = [] {
+            string text;
+            for (size_t i = 0; i < 20000; ++i)
+                text += "IF a <= b THEN BEGIN Write(a div b mod c, x <> y) END ELSE Read(x); VAR y : Integer; CONST z : Double := 1;\n";
+            return text;
+        }();
+        return source;
+    }
+
+    BENCHMARK(lexer_keyword_dense_views)
+    {
+        const string& source = keywordDenseSource();
+        Lexer lexer;
+        size_t count = 0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            NamePool pool;
+            count = lexer.TokenizeViews(source, pool).size();
+        }
+        setItemsPerIteration(static_cast<double>(count));
+        keepValue(static_cast<double>(count));
+    }
+}
@@ -0,0 +1,189 @@
+﻿#include "bench.h"
+#include "program_generator.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+
+volatile double benchSink = 0.0;
+
+static double itemsPerIteration = 0.0;
+static vector<pair<string, double>> counters;
+static double scaleFactor = 1.0;
+
+using benchClock = chrono::steady_clock;
+static benchClock::time_point pausedAt;
+static benchClock::duration pausedTotal{};
+
+void setItemsPerIteration(double items)
+{
+    itemsPerIteration = items;
+}
+
+void setCounter(const string& name, double perIteration)
+{
+    for (auto& counter : counters)
+    {
+        if (counter.first == name)
+        {
+            counter.second = perIteration;
+            return;
+        }
+    }
+    counters.emplace_back(name, perIteration);
+}
+
+void pauseTiming()
+{
+    pausedAt = benchClock::now();
+}
+
+void resumeTiming()
+{
+    pausedTotal += benchClock::now() - pausedAt;
+}
+
+size_t scaled(size_t size)
+{
+    double result = static_cast<double>(size) * scaleFactor;
+    return result < 1.0 ? 1 : static_cast<size_t>(result);
+}
+
+vector<BenchCase>& benchRegistry()
+{
+    static vector<BenchCase> registry;
+    return registry;
+}
+
+struct Measurement
+{
+    double nsPerIteration;
+    size_t iterations;
+};
+
+// Подбор числа итераций: удваиваем, пока замер не займет хотя бы minTime
+static Measurement measure(const BenchCase& bench, chrono::duration<double> minTime)
+{
+    bench.run(1); // Прогрев: построение общих данных замера не должно попадать в результат
+    size_t iterations = 1;
+    for (;;)
+    {
+        pausedTotal = benchClock::duration{};
+        auto start = benchClock::now();
+        bench.run(iterations);
+        chrono::duration<double> elapsed = benchClock::now() - start - pausedTotal;
+        if (elapsed >= minTime || iterations >= (size_t(1) << 40))
+            return { elapsed.count() * 1e9 / iterations, iterations };
+        iterations *= 2;
+    }
+}
+
+static string jsonEscape(const string& text)
+{
+    string result;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        result += c;
+    }
+    return result;
+}
+
+static void printUsage()
+{
+    cerr << "Usage: benchmark_project [name-filter] [--json <file>] [--scale <factor>] [--min-time <ms>]\n"
+            "       benchmark_project --generate <deep_if|long_expressions|many_declarations|write_heavy> <size>\n";
+}
+
+// Запуск: benchmark_project [подстрока имени] [--json файл] [--scale коэффициент] [--min-time мс]
+// --generate печатает сгенерированную программу (для запуска интерпретатором вне бенчмарков)
+int main(int argc, char* argv[])
+{
+    const char* filter = nullptr;
+    const char* jsonPath = nullptr;
+    double minTimeMs = 200.0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--json" && hasValue)
+            jsonPath = argv[++i];
+        else if (arg == "--scale" && hasValue)
+            scaleFactor = atof(argv[++i]);
+        else if (arg == "--min-time" && hasValue)
+            minTimeMs = atof(argv[++i]);
+        else if (arg == "--generate" && i + 2 < argc)
+        {
+            ProgramShape shape;
+            if (!ShapeFromName(argv[i + 1], shape))
+            {
+                printUsage();
+                return 2;
+            }
+            cout << GenerateProgram(shape, strtoul(argv[i + 2], nullptr, 10));
+            return 0;
+        }
+        else if (arg[0] != '-' && !filter)
+            filter = argv[i];
+        else
+        {
+            printUsage();
+            return 2;
+        }
+    }
+    if (scaleFactor <= 0.0 || minTimeMs <= 0.0)
+    {
+        printUsage();
+        return 2;
+    }
+
+    ofstream json;
+    if (jsonPath)
+    {
+        json.open(jsonPath);
+        if (!json)
+        {
+            cerr << "Cannot open " << jsonPath << endl;
+            return 1;
+        }
+        json << "{\n  \"scale\": " << scaleFactor << ",\n  \"benchmarks\": [" << fixed;
+    }
+
+    bool first = true;
+    for (const BenchCase& bench : benchRegistry())
+    {
+        if (filter && bench.name.find(filter) == string::npos)
+            continue;
+        itemsPerIteration = 0.0;
+        counters.clear();
+        Measurement m = measure(bench, chrono::duration<double, milli>(minTimeMs));
+        cout << left << setw(46) << bench.name << right << setw(12) << fixed << setprecision(2) << m.nsPerIteration << " ns/iter";
+        if (itemsPerIteration > 0.0)
+            cout << setw(12) << setprecision(2) << itemsPerIteration * 1e3 / m.nsPerIteration << " M items/s";
+        for (const auto& counter : counters)
+            cout << setw(10) << setprecision(2) << counter.second << " " << counter.first << "/iter";
+        cout << endl;
+
+        if (json.is_open())
+        {
+            json << (first ? "\n" : ",\n") << "    { \"name\": \"" << jsonEscape(bench.name) << "\""
+                 << ", \"iterations\": " << m.iterations
+                 << ", \"ns_per_iteration\": " << setprecision(3) << m.nsPerIteration;
+            if (itemsPerIteration > 0.0)
+                json << ", \"items_per_iteration\": " << setprecision(0) << itemsPerIteration
+                     << ", \"items_per_second\": " << setprecision(1) << itemsPerIteration * 1e9 / m.nsPerIteration;
+            for (const auto& counter : counters)
+                json << ", \"" << jsonEscape(counter.first) << "_per_iteration\": " << setprecision(3) << counter.second;
+            json << " }";
+            first = false;
+        }
+    }
+    if (json.is_open())
+        json << "\n  ]\n}\n";
+    return 0;
+}
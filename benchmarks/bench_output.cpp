@@ -0,0 +1,82 @@
+﻿#include "bench.h"
+#include "lexer.h"
+#include "output_sink.h"
+#include "parser.h"
+#include "program_executor.h"
+
+#include <fstream>
+
+// Вывод 1M строк Write в нулевое устройство: исполнение программы из 1M вызовов Write
+// (разбор исключен из замера), а также сам вывод строки "число пробел число" через
+// OutputSink против operator<< со std::endl, как Write выводил раньше
+
+namespace
+{
+    const size_t WriteCount = 1000000;
+
+#ifdef _WIN32
+    const char* const NullDevice = "NUL";
+#else
+    const char* const NullDevice = "/dev/null";
+#endif
+
+    const string& writeProgram()
+    {
+        static const string source = [] {
+            string text = "program Writes;\nvar\n    x : integer;\n    y : double;\nbegin\n    y := 0.25;\n";
+            for (size_t i = 0; i < WriteCount; ++i)
+                text += i % 2 ? "    Write(x, y);\n" : "    Write(\"x =\", x + 1);\n";
+            return text + "end.\n";
+        }();
+        return source;
+    }
+
+    BENCHMARK(write_1m_calls_execute)
+    {
+        ofstream out(NullDevice);
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            pauseTiming();
+            {
+                LexemeStream stream(writeProgram());
+                HLArena arena;
+                Parser parser;
+                HLNode* root = parser.BuildHList(stream, arena);
+                resumeTiming();
+                ProgramExecutor executor(out);
+                executor.Execute(root);
+                pauseTiming();
+            }
+            resumeTiming();
+        }
+        setItemsPerIteration(static_cast<double>(WriteCount));
+    }
+
+    BENCHMARK(write_1m_lines_ostream_endl)
+    {
+        ofstream out(NullDevice);
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            for (size_t line = 0; line < WriteCount; ++line)
+                out << static_cast<double>(line) << " " << line * 0.25 << endl;
+        }
+        setItemsPerIteration(static_cast<double>(WriteCount));
+    }
+
+    BENCHMARK(write_1m_lines_sink)
+    {
+        ofstream out(NullDevice);
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            OutputSink sink(out);
+            for (size_t line = 0; line < WriteCount; ++line)
+            {
+                sink.writeNumber(static_cast<double>(line));
+                sink.write(' ');
+                sink.writeNumber(line * 0.25);
+                sink.write('\n');
+            }
+        }
+        setItemsPerIteration(static_cast<double>(WriteCount));
+    }
+}
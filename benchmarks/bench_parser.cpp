@@ -0,0 +1,185 @@
+﻿#include "bench.h"
+#include "lexer.h"
+#include "parser.h"
+
+// Построение иерархического списка для программ из 1K, 10K и 100K операторов в MAIN_BLOCK.
+// Время на оператор должно почти не зависеть от размера программы (линейное построение).
+// Варианты _arena размещают узлы в HLArena и освобождают дерево целиком, _flat строят FlatAST.
+// parse_source_* - от текста до дерева: полный список лексем, затем разбор, против разбора
+// из LexemeStream без списка лексем
+// walk_* - обход всех узлов и лексем дерева из 100K операторов по указателям и по индексам
+
+namespace
+{
+    template <size_t StatementCount>
+    struct ParseFixture
+    {
+        string source;
+        vector<Lexeme> lexemes;
+
+        ParseFixture()
+        {
+            source = "program Parse;\nvar\n    a, b : integer;\nbegin\n";
+            for (size_t i = 0; i < StatementCount; ++i)
+            {
+                if (i % 8 == 0)
+                    source += "    if a > b then\n        begin\n        a := a - 1;\n        end\n    else\n        Write(a);\n";
+                else
+                    source += "    a := a + " + to_string(i) + " * b;\n";
+            }
+            source += "end.\n";
+            Lexer lexer;
+            lexemes = lexer.Tokenize(source);
+        }
+
+        static ParseFixture& instance()
+        {
+            static ParseFixture fixture;
+            return fixture;
+        }
+    };
+
+    template <size_t StatementCount>
+    void parseProgram(size_t iterations)
+    {
+        auto& f = ParseFixture<StatementCount>::instance();
+        size_t count = 0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            Parser parser;
+            HLNode* root = parser.BuildHList(f.lexemes);
+            count += root->pdown != nullptr;
+            delete root;
+        }
+        setItemsPerIteration(static_cast<double>(StatementCount));
+        keepValue(static_cast<double>(count));
+    }
+
+    template <size_t StatementCount>
+    void parseProgramArena(size_t iterations)
+    {
+        auto& f = ParseFixture<StatementCount>::instance();
+        size_t count = 0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            HLArena arena;
+            Parser parser;
+            HLNode* root = parser.BuildHList(f.lexemes, arena);
+            count += root->pdown != nullptr;
+        }
+        setItemsPerIteration(static_cast<double>(StatementCount));
+        keepValue(static_cast<double>(count));
+    }
+
+    template <size_t StatementCount>
+    void parseProgramFlat(size_t iterations)
+    {
+        auto& f = ParseFixture<StatementCount>::instance();
+        size_t count = 0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            Parser parser;
+            count += parser.BuildFlat(f.lexemes).size();
+        }
+        setItemsPerIteration(static_cast<double>(StatementCount));
+        keepValue(static_cast<double>(count));
+    }
+
+    BENCHMARK(parse_source_100k_tokenize_then_parse)
+    {
+        auto& f = ParseFixture<100000>::instance();
+        size_t count = 0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            Lexer lexer;
+            vector<Lexeme> lexemes = lexer.Tokenize(f.source);
+            HLArena arena;
+            Parser parser;
+            count += parser.BuildHList(lexemes, arena)->pdown != nullptr;
+        }
+        setItemsPerIteration(100000.0);
+        keepValue(static_cast<double>(count));
+    }
+
+    BENCHMARK(parse_source_100k_streaming)
+    {
+        auto& f = ParseFixture<100000>::instance();
+        size_t count = 0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            LexemeStream stream(f.source);
+            HLArena arena;
+            Parser parser;
+            count += parser.BuildHList(stream, arena)->pdown != nullptr;
+        }
+        setItemsPerIteration(100000.0);
+        keepValue(static_cast<double>(count));
+    }
+
+    // Дерево, построенное через new, как его строит BuildHList без региона
+    struct WalkFixture
+    {
+        HLNode* tree;
+        FlatAST flat;
+
+        WalkFixture()
+        {
+            Parser parser;
+            tree = parser.BuildHList(ParseFixture<100000>::instance().lexemes);
+            flat = FlattenHList(tree);
+        }
+
+        ~WalkFixture() { delete tree; }
+
+        static WalkFixture& instance()
+        {
+            static WalkFixture fixture;
+            return fixture;
+        }
+    };
+
+    BENCHMARK(walk_tree_100k_hlnode)
+    {
+        auto& f = WalkFixture::instance();
+        size_t count = 0;
+        vector<const HLNode*> stack;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            stack.assign(1, f.tree);
+            while (!stack.empty())
+            {
+                const HLNode* node = stack.back();
+                stack.pop_back();
+                count += node->expr.size() + node->type;
+                if (node->pnext) stack.push_back(node->pnext);
+                if (node->pdown) stack.push_back(node->pdown);
+            }
+        }
+        setItemsPerIteration(static_cast<double>(f.flat.size()));
+        keepValue(static_cast<double>(count));
+    }
+
+    BENCHMARK(walk_tree_100k_flat)
+    {
+        auto& f = WalkFixture::instance();
+        size_t count = 0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            // Порядок хранения совпадает с порядком обхода в глубину
+            for (size_t node = 0; node < f.flat.size(); ++node)
+                count += f.flat.exprSize(static_cast<int>(node)) + f.flat.kinds[node];
+        }
+        setItemsPerIteration(static_cast<double>(f.flat.size()));
+        keepValue(static_cast<double>(count));
+    }
+
+    BenchRegistrar parse1k("parse_statements_1k", parseProgram<1000>);
+    BenchRegistrar parse10k("parse_statements_10k", parseProgram<10000>);
+    BenchRegistrar parse100k("parse_statements_100k", parseProgram<100000>);
+    BenchRegistrar parse1kArena("parse_statements_1k_arena", parseProgramArena<1000>);
+    BenchRegistrar parse10kArena("parse_statements_10k_arena", parseProgramArena<10000>);
+    BenchRegistrar parse100kArena("parse_statements_100k_arena", parseProgramArena<100000>);
+    BenchRegistrar parse1kFlat("parse_statements_1k_flat", parseProgramFlat<1000>);
+    BenchRegistrar parse10kFlat("parse_statements_10k_flat", parseProgramFlat<10000>);
+    BenchRegistrar parse100kFlat("parse_statements_100k_flat", parseProgramFlat<100000>);
+}
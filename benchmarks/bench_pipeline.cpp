@@ -0,0 +1,201 @@
+﻿#include "bench.h"
+#include "program_generator.h"
+#include "lexer.h"
+#include "parser.h"
+#include "postfix.h"
+#include "program_executor.h"
+#include "bytecode.h"
+
+#include <iostream>
+#include <memory>
+
+// Сквозные замеры по фазам на сгенерированных программах разной формы:
+// pipeline_<форма>_tokenize - Lexer::Tokenize, _parse - Parser::BuildHList,
+// _postfix - PostfixExecutor::toPostfix + executePostfix для каждой правой части присваивания,
+// _execute - ProgramExecutor::Execute на свежем дереве (разбор исключен из замера, вывод отбрасывается),
+// _execute_bytecode - BytecodeExecutor::Execute на том же дереве (компиляция в байт-код + выполнение),
+// _vm - только BytecodeVM::Run заранее скомпилированной программы.
+// Размеры умножаются на --scale; пропускная способность - в лексемах (для _postfix - в выражениях)
+
+namespace
+{
+    // Поток вывода, который ничего не сохраняет
+    class NullBuffer : public streambuf
+    {
+    protected:
+        int overflow(int c) override { return c; }
+        streamsize xsputn(const char*, streamsize count) override { return count; }
+    };
+
+    struct PipelineFixture
+    {
+        string source;
+        vector<Lexeme> lexemes;
+        TableManager vartable;
+        vector<unique_ptr<HLNode>> expressions; // Правые части присваиваний как узлы STATEMENT
+
+        PipelineFixture(ProgramShape shape, size_t size)
+        {
+            source = GenerateProgram(shape, size);
+            Lexer lexer;
+            lexemes = lexer.Tokenize(source);
+
+            HLArena arena;
+            Parser parser;
+            collectExpressions(parser.BuildHList(lexemes, arena));
+        }
+
+        // Обход без рекурсии: цепочки pnext в больших программах длиной в десятки тысяч узлов
+        void collectExpressions(HLNode* root)
+        {
+            vector<HLNode*> pending = { root };
+            while (!pending.empty())
+            {
+                HLNode* node = pending.back();
+                pending.pop_back();
+                for (; node; node = node->pnext)
+                {
+                    if (node->pdown)
+                        pending.push_back(node->pdown);
+                    if (node->type != NodeType::STATEMENT || node->expr.size() < 3 || node->expr[1].value != ":=")
+                        continue;
+                    vector<Lexeme> rhs(node->expr.begin() + 2, node->expr.end());
+                    for (const Lexeme& lex : rhs)
+                    {
+                        if (lex.type == LexemeType::Identifier && !vartable.lookup(lex.value))
+                            vartable.addInt(lex.value, 3, false);
+                    }
+                    expressions.emplace_back(new HLNode(NodeType::STATEMENT, std::move(rhs)));
+                }
+            }
+        }
+    };
+
+    template <ProgramShape Shape>
+    PipelineFixture& fixture()
+    {
+        static PipelineFixture instance(Shape, scaled(Shape == ProgramShape::DeepIf ? 200 : 20000));
+        return instance;
+    }
+
+    template <ProgramShape Shape>
+    void tokenizePhase(size_t iterations)
+    {
+        auto& f = fixture<Shape>();
+        size_t count = 0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            Lexer lexer;
+            count += lexer.Tokenize(f.source).size();
+        }
+        setItemsPerIteration(static_cast<double>(f.lexemes.size()));
+        keepValue(static_cast<double>(count));
+    }
+
+    template <ProgramShape Shape>
+    void parsePhase(size_t iterations)
+    {
+        auto& f = fixture<Shape>();
+        size_t count = 0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            Parser parser;
+            HLNode* root = parser.BuildHList(f.lexemes);
+            count += root->pdown != nullptr;
+            delete root;
+        }
+        setItemsPerIteration(static_cast<double>(f.lexemes.size()));
+        keepValue(static_cast<double>(count));
+    }
+
+    template <ProgramShape Shape>
+    void postfixPhase(size_t iterations)
+    {
+        auto& f = fixture<Shape>();
+        PostfixExecutor postfix(&f.vartable);
+        double sum = 0.0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            for (const auto& node : f.expressions)
+            {
+                postfix.toPostfix(node.get());
+                sum += postfix.executePostfix();
+            }
+        }
+        setItemsPerIteration(static_cast<double>(f.expressions.size()));
+        keepValue(sum);
+    }
+
+    // Исполнитель для замера _execute: обход дерева (с JIT или без) или байт-код
+    enum class Backend { Tree, TreeJit, Bytecode };
+
+    template <ProgramShape Shape, Backend Kind = Backend::Tree>
+    void executePhase(size_t iterations)
+    {
+        auto& f = fixture<Shape>();
+        NullBuffer discard;
+        streambuf* old_cout = cout.rdbuf(&discard);
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            pauseTiming();
+            {
+                HLArena arena;
+                Parser parser;
+                HLNode* root = parser.BuildHList(f.lexemes, arena);
+                resumeTiming();
+                if constexpr (Kind == Backend::Bytecode) {
+                    BytecodeExecutor executor;
+                    executor.Execute(root);
+                }
+                else {
+                    ProgramExecutor executor;
+                    executor.setJit(Kind == Backend::TreeJit);
+                    executor.Execute(root);
+                }
+                pauseTiming();
+            }
+            resumeTiming();
+        }
+        cout.rdbuf(old_cout);
+        setItemsPerIteration(static_cast<double>(f.lexemes.size()));
+    }
+
+    template <ProgramShape Shape>
+    void vmPhase(size_t iterations)
+    {
+        auto& f = fixture<Shape>();
+        pauseTiming();
+        BytecodeProgram program;
+        {
+            HLArena arena;
+            Parser parser;
+            BytecodeCompiler compiler;
+            program = compiler.Compile(parser.BuildHList(f.lexemes, arena));
+        }
+        NullBuffer discard;
+        ostream out(&discard);
+        BytecodeVM vm(out);
+        resumeTiming();
+        for (size_t i = 0; i < iterations; ++i)
+            vm.Run(program);
+        setItemsPerIteration(static_cast<double>(f.lexemes.size()));
+    }
+
+#define PIPELINE_BENCHMARKS(name, shape) \
+    BenchRegistrar pipeline_##name##_tokenize("pipeline_" #name "_tokenize", tokenizePhase<shape>); \
+    BenchRegistrar pipeline_##name##_parse("pipeline_" #name "_parse", parsePhase<shape>); \
+    BenchRegistrar pipeline_##name##_postfix("pipeline_" #name "_postfix", postfixPhase<shape>); \
+    BenchRegistrar pipeline_##name##_execute("pipeline_" #name "_execute", executePhase<shape>); \
+    BenchRegistrar pipeline_##name##_execute_bytecode("pipeline_" #name "_execute_bytecode", \
+        executePhase<shape, Backend::Bytecode>); \
+    BenchRegistrar pipeline_##name##_vm("pipeline_" #name "_vm", vmPhase<shape>)
+
+    PIPELINE_BENCHMARKS(deep_if, ProgramShape::DeepIf);
+    PIPELINE_BENCHMARKS(long_expressions, ProgramShape::LongExpressions);
+    PIPELINE_BENCHMARKS(many_declarations, ProgramShape::ManyDeclarations);
+    PIPELINE_BENCHMARKS(write_heavy, ProgramShape::WriteHeavy);
+
+    // Каждое выражение программы выполняется один раз: замер показывает цену компиляции в машинный код
+    BenchRegistrar pipeline_long_expressions_execute_jit("pipeline_long_expressions_execute_jit",
+        executePhase<ProgramShape::LongExpressions, Backend::TreeJit>);
+}
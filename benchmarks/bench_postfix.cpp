@@ -0,0 +1,88 @@
+﻿#include "bench.h"
+#include "lexer.h"
+#include "postfix.h"
+
+// Вычисление выражения из 20 бинарных операторов: повторное исполнение скомпилированной
+// постфиксной записи (как в цикле программы) и компиляция с классификацией операторов.
+// Варианты _jit - то же с JIT (если его нет в сборке, выражение вычисляет интерпретатор)
+
+namespace
+{
+    const size_t OperatorCount = 20;
+
+    // Только integer-операнды: операции выполняются целочисленным путем
+    const char* const IntExpression =
+        "7 + 3 * 5 - 8 div 3 + 9 mod 4 * 2 - 6 + 1 * 8 div 2 - 3 + 4 mod 3 * 5 - 2 + 9 div 3 * 2 - 1";
+
+    // Вещественные операнды, "/" и сравнения в конце
+    const char* const MixedExpression =
+        "1.5 * 2 + 3 / 4 - 5.25 * 2 + 7 div 2 - 9 mod 4 + 0.5 * 8 / 3 - 1 + 6 * 2.5 / 5 - 4 > 2 = 1 <> 0";
+
+    vector<Lexeme> tokenize(const char* text)
+    {
+        Lexer lexer;
+        vector<Lexeme> lexemes = lexer.Tokenize(text);
+        size_t operators = 0;
+        for (const Lexeme& lex : lexemes)
+            operators += lex.type == LexemeType::Operator;
+        if (operators != OperatorCount)
+            throw runtime_error("bench_postfix: expected 20 operators in the expression");
+        return lexemes;
+    }
+
+    double evaluateCompiled(size_t iterations, const char* text, bool jit = false)
+    {
+        TableManager table;
+        PostfixExecutor executor(&table);
+        executor.setJit(jit);
+        vector<Lexeme> lexemes = tokenize(text);
+        CompiledExpr compiled;
+        executor.compile(lexemes, 0, lexemes.size(), compiled);
+
+        double sum = 0.0;
+        for (size_t i = 0; i < iterations; ++i)
+            sum += executor.executeTyped(compiled).asDouble();
+        return sum;
+    }
+
+    BENCHMARK(postfix_20_operators_int)
+    {
+        keepValue(evaluateCompiled(iterations, IntExpression));
+        setItemsPerIteration(static_cast<double>(OperatorCount));
+    }
+
+    BENCHMARK(postfix_20_operators_mixed)
+    {
+        keepValue(evaluateCompiled(iterations, MixedExpression));
+        setItemsPerIteration(static_cast<double>(OperatorCount));
+    }
+
+    BENCHMARK(postfix_20_operators_int_jit)
+    {
+        keepValue(evaluateCompiled(iterations, IntExpression, true));
+        setItemsPerIteration(static_cast<double>(OperatorCount));
+    }
+
+    BENCHMARK(postfix_20_operators_mixed_jit)
+    {
+        keepValue(evaluateCompiled(iterations, MixedExpression, true));
+        setItemsPerIteration(static_cast<double>(OperatorCount));
+    }
+
+    BENCHMARK(postfix_20_operators_compile)
+    {
+        TableManager table;
+        PostfixExecutor executor(&table);
+        vector<Lexeme> lexemes = tokenize(MixedExpression);
+
+        size_t total = 0;
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            CompiledExpr compiled;
+            executor.compile(lexemes, 0, lexemes.size(), compiled);
+            total += compiled.rpn.size();
+        }
+        setItemsPerIteration(static_cast<double>(OperatorCount));
+        keepValue(static_cast<double>(total));
+    }
+}
@@ -0,0 +1,153 @@
+﻿#include "bench.h"
+#include "tableManager.h"
+
+#include <stdexcept>
+
+// Чтение переменных вперемешку integer/double: старый путь через исключения,
+// поиск без исключений и чтение по заранее разрешенному слоту.
+// Кроме времени каждый замер сообщает число обращений к хеш-таблице на итерацию (lookups/iter)
+
+namespace
+{
+    const size_t VariableCount = 16;
+
+    struct LookupFixture
+    {
+        TableManager table;
+        vector<string> names;
+        vector<int> slots;
+
+        LookupFixture()
+        {
+            for (size_t i = 0; i < VariableCount; ++i)
+            {
+                string name = "v" + to_string(i);
+                if (i % 2 == 0)
+                    table.addInt(name, static_cast<int>(i), false);
+                else
+                    table.addDouble(name, i + 0.5, false);
+                names.push_back(name);
+                slots.push_back(table.findSlot(name));
+            }
+        }
+    };
+
+    LookupFixture& fixture()
+    {
+        static LookupFixture instance;
+        return instance;
+    }
+
+    // Считает обращения к таблице: каждый вызов по имени - ровно одна проба хеш-таблицы,
+    // доступ по слоту таблицу не затрагивает
+    class CountingTable
+    {
+        TableManager& table;
+
+    public:
+        size_t lookups = 0;
+
+        explicit CountingTable(TableManager& table) : table(table) {}
+
+        bool hasInt(const string& name) { ++lookups; return table.hasInt(name); }
+        bool hasDouble(const string& name) { ++lookups; return table.hasDouble(name); }
+        int& getInt(const string& name) { ++lookups; return table.getInt(name); }
+        double& getDouble(const string& name) { ++lookups; return table.getDouble(name); }
+        const int& getIntConst(const string& name) { ++lookups; return table.getIntConst(name); }
+        const double& getDoubleConst(const string& name) { ++lookups; return table.getDoubleConst(name); }
+        Symbol* lookup(const string& name) { ++lookups; return table.lookup(name); }
+        double readSlot(int slot) const { return table.readSlot(slot); }
+
+        void report(size_t iterations) const
+        {
+            setCounter("lookups", iterations ? static_cast<double>(lookups) / iterations : 0.0);
+        }
+    };
+
+    // Так читал значения PostfixExecutor::getValueFromLexeme до перехода на lookup:
+    // промах в таблице double обрабатывался исключением out_of_range
+    double readThrowing(CountingTable& table, const string& name)
+    {
+        try
+        {
+            return table.getDoubleConst(name);
+        }
+        catch (const out_of_range&)
+        {
+            return static_cast<double>(table.getIntConst(name));
+        }
+    }
+}
+
+BENCHMARK(table_read_mixed_throwing)
+{
+    LookupFixture& f = fixture();
+    CountingTable table(f.table);
+    double sum = 0.0;
+    for (size_t i = 0; i < iterations; ++i)
+        sum += readThrowing(table, f.names[i % VariableCount]);
+    keepValue(sum);
+    table.report(iterations);
+}
+
+BENCHMARK(table_read_mixed_lookup)
+{
+    LookupFixture& f = fixture();
+    CountingTable table(f.table);
+    double sum = 0.0;
+    for (size_t i = 0; i < iterations; ++i)
+        sum += table.lookup(f.names[i % VariableCount])->value();
+    keepValue(sum);
+    table.report(iterations);
+}
+
+BENCHMARK(table_read_mixed_slot)
+{
+    LookupFixture& f = fixture();
+    CountingTable table(f.table);
+    double sum = 0.0;
+    for (size_t i = 0; i < iterations; ++i)
+        sum += table.readSlot(f.slots[i % VariableCount]);
+    keepValue(sum);
+    table.report(iterations);
+}
+
+// Присваивание и чтение по имени, как в handleStatement: проверка типа через hasInt/hasDouble
+// и затем доступ getInt/getDouble (2-3 пробы таблицы на присваивание, 2 на чтение)
+// против одного lookup на операцию
+BENCHMARK(named_assign_read_has_get)
+{
+    LookupFixture& f = fixture();
+    CountingTable table(f.table);
+    double sum = 0.0;
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        const string& name = f.names[i % VariableCount];
+        if (table.hasInt(name))
+            table.getInt(name) = static_cast<int>(i);
+        else if (table.hasDouble(name))
+            table.getDouble(name) = static_cast<double>(i);
+        sum += table.hasInt(name) ? table.getIntConst(name) : table.getDoubleConst(name);
+    }
+    keepValue(sum);
+    table.report(iterations);
+}
+
+BENCHMARK(named_assign_read_lookup)
+{
+    LookupFixture& f = fixture();
+    CountingTable table(f.table);
+    double sum = 0.0;
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        const string& name = f.names[i % VariableCount];
+        Symbol* symbol = table.lookup(name);
+        if (symbol->isInteger)
+            symbol->intValue = static_cast<int>(i);
+        else
+            symbol->doubleValue = static_cast<double>(i);
+        sum += symbol->value();
+    }
+    keepValue(sum);
+    table.report(iterations);
+}
@@ -0,0 +1,145 @@
+﻿#include "program_generator.h"
+
+namespace
+{
+    const size_t VariableCount = 8;
+
+    string variable(size_t index)
+    {
+        return "x" + to_string(index % VariableCount);
+    }
+
+    string variableSection()
+    {
+        string text = "var\n    ";
+        for (size_t v = 0; v < VariableCount; ++v)
+            text += (v ? ", " : "") + variable(v);
+        return text + " : integer;\n    y : double;\n";
+    }
+
+    string indent(size_t level)
+    {
+        return string(4 * (level + 1), ' ');
+    }
+
+    // Сумма terms слагаемых вида x * k mod 97: значения переменных остаются ограниченными,
+    // сколько бы присваиваний ни выполнилось
+    string expression(size_t seed, size_t terms)
+    {
+        static const char* const additive[] = { " + ", " - " };
+        string text = variable(seed) + " mod 97";
+        for (size_t t = 1; t < terms; ++t)
+        {
+            text += additive[(seed + t) % 2];
+            switch ((seed + t) % 3)
+            {
+            case 0: text += variable(seed + t) + " * " + to_string(t % 7 + 2) + " mod 97"; break;
+            case 1: text += variable(seed + t) + " div " + to_string(t % 5 + 1); break;
+            default: text += to_string(seed % 100 + t); break;
+            }
+        }
+        return text;
+    }
+
+    string deepIf(size_t depth)
+    {
+        string text = "program DeepIf;\n" + variableSection() + "begin\n    x0 := 1;\n";
+        for (size_t level = 0; level < depth; ++level)
+        {
+            text += indent(level) + "if x0 > 0 then\n";
+            text += indent(level) + "begin\n";
+            text += indent(level + 1) + variable(level + 1) + " := x0 + " + to_string(level) + ";\n";
+        }
+        text += indent(depth) + "Write(x1, x2);\n";
+        for (size_t level = depth; level-- > 0;)
+        {
+            text += indent(level) + "end\n";
+            text += indent(level) + "else\n";
+            text += indent(level + 1) + "Write(\"unreachable\");\n";
+        }
+        return text + "end.\n";
+    }
+
+    string longExpressions(size_t statements, size_t terms)
+    {
+        string text = "program LongExpressions;\n" + variableSection() + "begin\n";
+        for (size_t i = 0; i < statements; ++i)
+        {
+            if (i % 4 == 3)
+                text += "    y := " + variable(i) + " / 7 + y * 0.5;\n";
+            else
+                text += "    " + variable(i) + " := " + expression(i, terms) + ";\n";
+        }
+        return text + "    Write(x0, y);\nend.\n";
+    }
+
+    string manyDeclarations(size_t count)
+    {
+        string text = "program ManyDeclarations;\nconst\n";
+        for (size_t i = 0; i < count; ++i)
+            text += "    c" + to_string(i) + " = " + to_string(i) + ";\n";
+        text += "var\n";
+        for (size_t i = 0; i < count; i += 4)
+        {
+            text += "    v" + to_string(i);
+            for (size_t j = i + 1; j < i + 4 && j < count; ++j)
+                text += ", v" + to_string(j);
+            text += i % 8 == 0 ? " : integer;\n" : " : double;\n";
+        }
+        text += "begin\n";
+        for (size_t i = 0; i < count; i += 16)
+            text += "    v" + to_string(i) + " := c" + to_string(i) + " + 1;\n";
+        return text + "end.\n";
+    }
+
+    string writeHeavy(size_t count)
+    {
+        string text = "program WriteHeavy;\n" + variableSection() + "begin\n    y := 0.25;\n";
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (i % 2 == 0)
+                text += "    Write(\"line\", " + to_string(i) + ", " + variable(i) + ", y * " + to_string(i % 9) + ");\n";
+            else
+                text += "    Write(" + variable(i) + " + " + to_string(i) + ", y);\n";
+        }
+        return text + "end.\n";
+    }
+}
+
+const char* ShapeName(ProgramShape shape)
+{
+    switch (shape)
+    {
+    case ProgramShape::DeepIf: return "deep_if";
+    case ProgramShape::LongExpressions: return "long_expressions";
+    case ProgramShape::ManyDeclarations: return "many_declarations";
+    case ProgramShape::WriteHeavy: return "write_heavy";
+    }
+    return "unknown";
+}
+
+bool ShapeFromName(const string& name, ProgramShape& shape)
+{
+    for (ProgramShape candidate : { ProgramShape::DeepIf, ProgramShape::LongExpressions,
+                                    ProgramShape::ManyDeclarations, ProgramShape::WriteHeavy })
+    {
+        if (name == ShapeName(candidate))
+        {
+            shape = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+string GenerateProgram(ProgramShape shape, size_t size, size_t exprTerms)
+{
+    switch (shape)
+    {
+    case ProgramShape::DeepIf: return deepIf(size);
+    case ProgramShape::LongExpressions: return longExpressions(size, exprTerms);
+    case ProgramShape::ManyDeclarations: return manyDeclarations(size);
+    case ProgramShape::WriteHeavy: return writeHeavy(size);
+    }
+    return string();
+}
@@ -0,0 +1,22 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+// Генератор синтетических программ на Pascal-- для бенчмарков.
+// Все программы корректны и выполняются без ошибок и без ввода (Read не используется).
+enum class ProgramShape
+{
+    DeepIf,             // size уровней вложенных if ... then begin ... end else ...
+    LongExpressions,    // size присваиваний, в правой части по exprTerms слагаемых
+    ManyDeclarations,   // size констант и size переменных, немного присваиваний
+    WriteHeavy          // size вызовов Write со строками и выражениями
+};
+
+const char* ShapeName(ProgramShape shape);
+// Форма по имени ("deep_if", "long_expressions", ...); false, если имя неизвестно
+bool ShapeFromName(const string& name, ProgramShape& shape);
+
+string GenerateProgram(ProgramShape shape, size_t size, size_t exprTerms = 16);
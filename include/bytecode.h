@@ -0,0 +1,157 @@
+#pragma once
+
+#include "hierarchical_list.h"
+#include "output_sink.h"
+#include "input_source.h"
+#include "postfix.h"
+#include "tableManager.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Команды байт-кода. Операнд a - индекс константы/строки/слота или адрес перехода.
+// Типы значений известны при компиляции (как в PostfixExecutor::inferTypes), поэтому
+// операции integer и double - разные команды: integer-арифметика 64-битная с переполнением
+// по модулю 2^64, сравнения дают integer 0/1, как при обходе дерева.
+enum class OpCode : uint8_t
+{
+    PushConst,      // Положить на стек double constants[a]
+    PushInt,        // Положить на стек integer intConstants[a]
+    Load,           // Положить на стек значение слота a
+    Store,          // Снять double со стека и записать в слот a
+    StoreInt,       // Снять integer со стека и записать в integer-слот a с усечением до int
+    ToReal,         // Перевести integer на вершине стека в double
+    ToRealLhs,      // То же для значения под вершиной (левый операнд)
+    Truncate,       // Перевести double на вершине стека в integer с отбрасыванием дробной части
+    Collapse,       // Оставить на стеке только верхнее значение из a + 1 верхних
+    Add, Sub, Mul, Div, IntDiv, Mod,
+    Eq, Ne, Lt, Gt, Le, Ge,
+    AddInt, SubInt, MulInt, IntDivInt, ModInt,
+    EqInt, NeInt, LtInt, GtInt, LeInt, GeInt,
+    Jump,           // Безусловный переход на адрес a
+    JumpIfFalse,    // Снять double со стека, перейти на адрес a, если оно равно нулю
+    JumpIfFalseInt, // То же для integer
+    WriteValue,     // Снять double со стека и вывести его
+    WriteInt,       // Снять integer со стека и вывести его
+    WriteString,    // Вывести строку strings[a]
+    WriteSpace,     // Вывести разделитель аргументов Write
+    WriteLine,      // Завершить строку вывода Write
+    Read,           // Прочитать число в слот a (с приглашением)
+    Fail,           // Ошибка времени выполнения с сообщением strings[a]
+    Halt
+};
+
+struct Instr
+{
+    OpCode op;
+    int32_t a;
+};
+
+// Ячейка стека и слота VM: поле выбирает команда (i - integer, d - double)
+union VMCell
+{
+    long long i;
+    double d;
+};
+
+// Переменная программы, размещенная в слоте
+struct BytecodeSlot
+{
+    string name;
+    bool isInteger;
+};
+
+// Результат компиляции: линейный код с разрешенными адресами переходов
+struct BytecodeProgram
+{
+    vector<Instr> code;
+    vector<double> constants;
+    vector<long long> intConstants;
+    vector<string> strings;
+    vector<BytecodeSlot> slots;
+    size_t maxStack = 0;        // Максимальная глубина стека вычислений
+};
+
+// Понижает иерархический список (PROGRAM, CONST_SECTION, VAR_SECTION, MAIN_BLOCK,
+// IF/ELSE, STATEMENT, CALL) в линейный байт-код.
+// Константы вычисляются при компиляции и подставляются в код как литералы.
+// Ошибки, которые ProgramExecutor обнаружил бы только при выполнении узла
+// (необъявленный идентификатор, присваивание константе и т.п.), компилируются
+// в команду Fail на месте узла, поэтому проявляются в тот же момент исполнения.
+class BytecodeCompiler
+{
+    TableManager decltable;         // Все объявленные имена; значения констант известны при компиляции
+    PostfixExecutor postfix;        // Построение постфиксной записи и вычисление констант
+    BytecodeProgram program;
+    unordered_map<string, int> slotIndex;   // Слот переменной по имени
+    unordered_map<uint64_t, int> constantIndex; // Индекс константы по битам ее значения
+    unordered_map<long long, int> intConstantIndex;
+    size_t depth = 0;               // Текущая глубина стека вычислений
+
+    int findSlot(const string& name) const;
+    int addConstant(double value);
+    int addIntConstant(long long value);
+    int addString(const string& text);
+    size_t emit(OpCode op, int32_t a = 0);
+    void emitFail(const string& message);
+    void push(size_t count = 1);
+    void pop(size_t count = 1);
+
+    void compileDeclarations(HLNode* section);
+    void compileBlock(HLNode* first);
+    HLNode* compileNode(HLNode* node);   // Возвращает следующий узел последовательности
+    void compileStatement(HLNode* node);
+    void compileIf(HLNode* node);
+    void compileCall(HLNode* node);
+    // Код вычисления лексем [first, last), оставляющий на стеке ровно одно значение; возвращает его тип
+    ValueType compileExpression(const vector<Lexeme>& expr, size_t first, size_t last);
+
+public:
+    BytecodeCompiler() : postfix(&decltable) {}
+
+    BytecodeProgram Compile(HLNode* head);
+};
+
+// Интерпретатор байт-кода
+class BytecodeVM
+{
+    vector<VMCell> slots;
+    vector<VMCell> stack;
+    OutputSink output;
+    StreamInputSource consoleInput;
+    InputSource* input;
+    bool prompts = true;
+
+    void execute(const BytecodeProgram& program);
+
+public:
+    explicit BytecodeVM(ostream& out = cout) : output(out), consoleInput(cin), input(&consoleInput) {}
+
+    void setInput(InputSource& source) { input = &source; }
+    void setPrompts(bool enabled) { prompts = enabled; }
+
+    void Run(const BytecodeProgram& program);
+
+    // Значение слота после Run; поле - по типу переменной (BytecodeProgram::slots)
+    VMCell getSlot(size_t index) const { return slots.at(index); }
+};
+
+// Альтернатива ProgramExecutor с тем же интерфейсом: компиляция + выполнение байт-кода
+class BytecodeExecutor
+{
+    BytecodeVM vm;
+
+public:
+    explicit BytecodeExecutor(ostream& out = cout) : vm(out) {}
+
+    void setInput(InputSource& source) { vm.setInput(source); }
+    void setPrompts(bool enabled) { vm.setPrompts(enabled); }
+
+    void Execute(HLNode* head);
+};
+
+// Текстовое представление байт-кода (для отладки и тестов)
+string BytecodeToString(const BytecodeProgram& program);
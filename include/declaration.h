@@ -0,0 +1,23 @@
+#pragma once
+#include "hierarchical_list.h"
+#include <functional>
+#include <string>
+
+using namespace std;
+
+// Один элемент узла DECLARATION: Имя [: Тип] [= Выражение]
+struct DeclarationItem
+{
+    string name;        // Имя переменной или константы
+    string typeName;    // "integer", "double" или пустая строка, если тип не указан
+    bool isConstant;    // Константа, если есть '='
+    size_t valueFirst;  // Диапазон [valueFirst, valueLast) выражения значения в expr (для констант)
+    size_t valueLast;
+
+    // Тип по умолчанию: константы без типа - double, переменные без типа - integer
+    bool isInteger() const { return typeName.empty() ? !isConstant : typeName == "integer"; }
+};
+
+// Разбирает узел DECLARATION и по порядку вызывает handler для каждого объявленного имени.
+// Синтаксические ошибки сообщаются через runtime_error.
+void forEachDeclarationItem(const HLNode* node, const function<void(const DeclarationItem&)>& handler);
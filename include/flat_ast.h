@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include "hierarchical_list.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Плоское представление дерева программы (структура массивов) - альтернатива HLNode.
+// Узел - индекс в параллельных массивах; связи pdown/pnext заменены индексами
+// firstChild/nextSibling, лексемы всех выражений лежат подряд в одном массиве tokens.
+// Узлы хранятся в порядке обхода в глубину (родитель перед детьми, дети по порядку),
+// поэтому обход программы идет по памяти последовательно. Корень PROGRAM - узел 0.
+struct FlatAST
+{
+    static constexpr int None = -1;
+
+    vector<NodeType> kinds;
+    vector<int> firstChild;         // Первый вложенный узел (аналог pdown) или None
+    vector<int> nextSibling;        // Следующий узел того же уровня (аналог pnext) или None
+    vector<uint32_t> exprFirst;     // Диапазон [exprFirst, exprLast) выражения узла в tokens
+    vector<uint32_t> exprLast;
+    vector<Lexeme> tokens;
+
+    size_t size() const { return kinds.size(); }
+    bool empty() const { return kinds.empty(); }
+
+    // Добавляет узел без связей; возвращает его индекс
+    int addNode(NodeType kind, const Lexeme* first, const Lexeme* last);
+    int addNode(NodeType kind, vector<Lexeme>&& expr);  // Лексемы переносятся без копирования строк
+
+    size_t exprSize(int node) const { return exprLast[node] - exprFirst[node]; }
+    const Lexeme* exprBegin(int node) const { return tokens.data() + exprFirst[node]; }
+    const Lexeme* exprEnd(int node) const { return tokens.data() + exprLast[node]; }
+    vector<Lexeme> expr(int node) const { return vector<Lexeme>(exprBegin(node), exprEnd(node)); }
+};
+
+// Преобразование иерархического списка в плоское дерево (без рекурсии)
+FlatAST FlattenHList(const HLNode* root);
+
+// Обратное преобразование; узлы размещаются в arena или, если он не задан, через new
+HLNode* ExpandFlatAST(const FlatAST& ast, HLArena* arena = nullptr);
+
+// Тот же текст, что HLNodeToString для соответствующего HLNode
+std::string HLNodeToString(const FlatAST& ast, int node = 0, int level = 0);
@@ -1,5 +1,10 @@
 ﻿#pragma once
 #include"lexer.h"
+#include "value.h"
+#include "operators.h"
+#include <memory>
+#include <type_traits>
+#include <utility>
 
 enum NodeType 
 {
@@ -14,20 +19,92 @@ enum NodeType
 	CALL // вызов функции
 };
 
+// Элемент постфиксной записи с выведенным типом
+struct TypedItem
+{
+    ValueType type;     // Операнд: его тип; оператор: тип, в котором выполняется операция
+    Value literal;      // Значение числового литерала (разбирается при компиляции)
+    OperatorKind op = OperatorKind::None; // Оператор: его вид (классифицируется при компиляции)
+};
+
+// Скомпилированное выражение узла: постфиксная запись строится один раз
+// при первом вычислении и далее используется повторно
+struct CompiledExpr
+{
+    vector<Lexeme> rpn;         // Постфиксная запись выражения
+    vector<TypedItem> items;    // Типы элементов rpn (выводятся один раз при компиляции)
+    size_t maxDepth = 0;        // Наибольшая глубина стека при вычислении
+    bool balanced = false;      // Каждому оператору хватает операндов, посторонних лексем нет:
+                                // вычисление идет без проверок стека
+
+    // Машинный код выражения (см. jit.h); nullptr - выражение вычисляет интерпретатор.
+    // Код действителен, пока жив JitCompiler с поколением nativeOwner. Поля - кэш вычисления:
+    // выражение компилируется в машинный код при вычислении, после нескольких вызовов
+    mutable int (*native)(const void* symbols, long long* result) = nullptr;
+    mutable ValueType nativeType = ValueType::Unknown; // Тип результата машинного кода
+    mutable uint64_t nativeOwner = 0;
+    mutable uint32_t evaluations = 0;   // Число вычислений интерпретатором (порог JIT)
+};
+
 struct HLNode 
 {
     NodeType type;          // Òèï óçëà
     vector<Lexeme> expr;    // Ëåêñåìû óñëîâèÿ èëè îïåðàòîðà
     HLNode* pnext = nullptr;// Ñëåäóþùèé ýëåìåíò íà òîì æå óðîâíå
     HLNode* pdown = nullptr;// Âëîæåííàÿ ñòðóêòóðà (òåëî if/else)
+    CompiledExpr* compiled = nullptr; // Кэш постфиксной формы выражения (владеет узел)
 
-    HLNode(NodeType t, const vector<Lexeme>& lex)
-        : type(t), expr(lex) {
+    HLNode(NodeType t, vector<Lexeme> lex)
+        : type(t), expr(std::move(lex)) {
     }
 
+    // Добавление в конец цепочки (проходит цепочку целиком; для построения списков - HLNodeAppender)
     void addNext(HLNode* child);
     void addChild(HLNode* child);
+    // Удаляет ветки pdown и pnext без рекурсии, поэтому длина цепочек не ограничена стеком
     ~HLNode();
 };
 
+// Регион для узлов одного разбора: узлы размещаются подряд в больших блоках
+// и освобождаются все сразу вместе с регионом (без обхода связей).
+// Узлы региона нельзя удалять через delete; регион должен жить, пока используется дерево.
+// Лексемы узла (expr) по-прежнему хранятся в собственном vector каждого узла.
+class HLArena
+{
+    using Slot = typename std::aligned_storage<sizeof(HLNode), alignof(HLNode)>::type;
+
+    static const size_t BlockSize = 1024;  // Узлов в одном блоке
+
+    vector<unique_ptr<Slot[]>> blocks;
+    size_t used = BlockSize;               // Занято слотов в последнем блоке
+    size_t count = 0;
+
+public:
+    HLArena() = default;
+    HLArena(const HLArena&) = delete;
+    HLArena& operator=(const HLArena&) = delete;
+    ~HLArena();
+
+    HLNode* create(NodeType type, vector<Lexeme> expr = {});
+
+    size_t nodeCount() const { return count; }
+};
+
+// Добавление дочерних узлов в конец цепочки pdown родителя за O(1):
+// запоминает последний узел, поэтому построение блока из N операторов линейно
+class HLNodeAppender
+{
+    HLNode* parent;
+    HLNode* tail = nullptr;     // Последний узел цепочки pdown (nullptr, если цепочка пуста)
+
+public:
+    // Уже существующая цепочка проходится один раз
+    explicit HLNodeAppender(HLNode* parent);
+
+    // Добавляет узел вместе с его цепочкой pnext (например, IF со связанным ELSE)
+    void append(HLNode* child);
+
+    HLNode* node() const { return parent; }
+};
+
 
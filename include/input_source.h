@@ -0,0 +1,78 @@
+﻿#pragma once
+
+#include "source_file.h"
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// Источник значений для Read. Значения - числа, разделенные пробельными символами.
+class InputSource
+{
+public:
+    virtual ~InputSource() = default;
+    // Следующее значение в value; false, если ввод закончился или очередное слово не число
+    // (некорректное слово пропускается вместе с остатком строки)
+    virtual bool next(double& value) = 0;
+    // Источник ждёт пользователя (терминал): накопленный вывод нужно показать до чтения
+    virtual bool interactive() const { return false; }
+};
+
+// Разбор числа из всего диапазона [first, last) через from_chars (без локали);
+// допускает знак '+', как operator>>
+bool ParseNumber(const char* first, const char* last, double& value);
+
+// Чтение из потока (по умолчанию stdin): символы берутся прямо из streambuf потока,
+// который запрашивается при каждом чтении, поэтому подмена rdbuf продолжает работать.
+// Поток читается не дальше конца текущего слова, так что интерактивный ввод не блокируется.
+class StreamInputSource : public InputSource
+{
+    istream& stream;
+    bool fromUser;
+
+public:
+    explicit StreamInputSource(istream& stream = cin, bool interactive = false)
+        : stream(stream), fromUser(interactive) {}
+
+    bool next(double& value) override;
+    bool interactive() const override { return fromUser; }
+};
+
+// Чтение из текста в памяти без копирования; текст должен жить дольше источника
+class BufferInputSource : public InputSource
+{
+    const char* pos;
+    const char* end;
+
+public:
+    explicit BufferInputSource(string_view text) : pos(text.data()), end(text.data() + text.size()) {}
+
+    bool next(double& value) override;
+};
+
+// Файл с данными: отображается в память (SourceFile) и разбирается как BufferInputSource
+class FileInputSource : public InputSource
+{
+    SourceFile file;
+    BufferInputSource buffer;
+
+public:
+    explicit FileInputSource(const string& path) : file(path), buffer(file.text()) {}
+
+    bool next(double& value) override { return buffer.next(value); }
+};
+
+// Заранее подготовленные значения (без разбора текста)
+class ArrayInputSource : public InputSource
+{
+    vector<double> values;
+    size_t pos = 0;
+
+public:
+    explicit ArrayInputSource(vector<double> values) : values(std::move(values)) {}
+
+    bool next(double& value) override;
+};
@@ -0,0 +1,58 @@
+﻿#pragma once
+
+#include "hierarchical_list.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Коды возврата машинного кода выражения: 0 - результат записан, иначе ошибка времени выполнения
+enum JitStatus : int
+{
+    JitOk = 0,
+    JitDivisionByZero = 1,      // "/" на ноль
+    JitIntDivisionByZero = 2,   // div на ноль
+    JitModByZero = 3            // mod на ноль
+};
+
+// JIT-компилятор выражений в машинный код x86-64 (SSE2 для double, целочисленные инструкции
+// для integer). Компилируются сбалансированные выражения, у которых типы всех операндов
+// и операций выведены при компиляции, а операторы - арифметика и сравнения; остальные
+// выражения остаются интерпретатору. Код пишется в исполняемые страницы, которыми владеет
+// компилятор: указатели в CompiledExpr::native действительны, пока он жив.
+//
+// Функция выражения: int f(const Symbol* symbols, long long* result). Таблица передается при
+// каждом вызове (вектор символов может переместиться); результат - биты integer или double
+// в *result, тип - CompiledExpr::nativeType. Деление на ноль возвращает код JitStatus.
+class JitCompiler
+{
+    struct Chunk
+    {
+        uint8_t* data;
+        size_t size;
+        size_t used;
+    };
+
+    vector<Chunk> chunks;
+    uint64_t id;
+
+    // Копирует код в исполняемую память; nullptr, если память не выделена
+    const uint8_t* install(const vector<uint8_t>& code);
+
+public:
+    JitCompiler();
+    ~JitCompiler();
+
+    JitCompiler(const JitCompiler&) = delete;
+    JitCompiler& operator=(const JitCompiler&) = delete;
+
+    // Есть ли JIT в этой сборке (x86-64, не отключен PASCAL_NO_JIT)
+    static bool available();
+
+    // Компилирует выражение после вывода типов; false - выражение остается интерпретатору
+    bool compile(const CompiledExpr& expr);
+
+    // Уникальный номер компилятора: код чужого (в том числе уничтоженного) компилятора не вызывается
+    uint64_t generation() const { return id; }
+};
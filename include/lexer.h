@@ -1,7 +1,11 @@
-#pragma once
+﻿#pragma once
 #include <vector>
 #include <map>
 #include<string>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+#include "value.h"
 using namespace std;
 
 enum class LexemeType { Unknown, Keyword, Identifier, VarType, Number, Operator, Separator, StringLiteral, EndOfFile};
@@ -12,6 +16,10 @@ struct Lexeme
 {
 	LexemeType type;
 	string value;
+	int slot = -1; // Слот идентификатора в TableManager (-1, если имя не разрешено)
+	// Значение числового литерала, разобранное лексером один раз. Тип Unknown - лексема
+	// создана не лексером, тогда значение получается из текста через NumberValue
+	Value number = Value::unknown();
 
 	bool operator==(const Lexeme& other) const 
 	{
@@ -19,12 +27,99 @@ struct Lexeme
 	}
 };
 
+// Пул интернированных имен: каждое различное слово хранится один раз,
+// токены ссылаются на него по номеру
+class NamePool
+{
+	deque<string> names;                    // deque не перемещает элементы, поэтому ключи index остаются валидными
+	unordered_map<string_view, int> index;
+public:
+	int intern(string_view name);
+	string_view name(int id) const { return names[id]; }
+	size_t size() const { return names.size(); }
+};
+
+// Лексема без копирования текста: ссылается на фрагмент исходного кода
+struct Token
+{
+	LexemeType type;
+	string_view text;   // Фрагмент исходного текста (у строкового литерала - без кавычек)
+	int name = -1;      // Для слов (имена, ключевые слова, div/mod): номер в NamePool, в нижнем регистре
+	Value number = Value::unknown(); // Для чисел: значение литерала
+};
+
+// Числовой литерал: целое ([-]цифры, помещается в 64 бита) или double (from_chars, весь текст).
+// false, если текст не является числом
+bool ParseNumberLiteral(string_view text, Value& out);
+
+// Значение лексемы Number: разобранное лексером или (для созданных вручную) разобранное из текста;
+// некорректный текст - runtime_error
+Value NumberValue(const Lexeme& lex);
+
 std::ostream& operator<<(std::ostream& os, const Lexeme& lexeme);
 string lexvectostr(vector<Lexeme> v);
 
+// Ключевые слова, операторы и разделители распознаются таблицей классов символов
+// и ветвлением по длине слова (см. lexer.cpp), без поиска по словарю
 class Lexer
 {
-	static map <string, LexemeType> Database;
 public:
 	vector<Lexeme> Tokenize(const string& sourceCode);
+
+	// Токенизация без выделения строк на каждую лексему: токены ссылаются на sourceCode,
+	// слова интернируются в pool. sourceCode и pool должны жить, пока используются токены.
+	vector<Token> TokenizeViews(string_view sourceCode, NamePool& pool);
+};
+
+// Преобразование токена в лексему с собственной строкой (для Parser и исполнителей)
+Lexeme ToLexeme(const Token& token, const NamePool& pool);
+
+// Лексический анализ по требованию: каждый вызов next() сканирует одну лексему.
+// После конца текста next() возвращает EndOfFile.
+class TokenStream
+{
+	string_view source;
+	NamePool& pool;
+	size_t pos = 0;
+	string lower_word; // Буфер для перевода слов в нижний регистр, переиспользуется
+
+public:
+	TokenStream(string_view sourceCode, NamePool& pool) : source(sourceCode), pool(pool) {}
+
+	Token next();
+};
+
+// Источник лексем для Parser: выдает их по одной, не требуя всего списка в памяти
+class LexemeSource
+{
+public:
+	virtual ~LexemeSource() = default;
+	// Следующая лексема в out; false, если лексемы закончились (после EndOfFile)
+	virtual bool next(Lexeme& out) = 0;
+};
+
+// Лексемы из готового вектора (без копирования вектора)
+class VectorLexemeSource : public LexemeSource
+{
+	const vector<Lexeme>& lexemes;
+	size_t pos = 0;
+
+public:
+	explicit VectorLexemeSource(const vector<Lexeme>& lexemes) : lexemes(lexemes) {}
+
+	bool next(Lexeme& out) override;
+};
+
+// Лексемы прямо из исходного текста: лексер работает по мере чтения их парсером,
+// в памяти одновременно только текущая лексема и пул имен
+class LexemeStream : public LexemeSource
+{
+	NamePool pool;
+	TokenStream tokens;
+	bool finished = false;
+
+public:
+	explicit LexemeStream(string_view sourceCode) : tokens(sourceCode, pool) {}
+
+	bool next(Lexeme& out) override;
 };
\ No newline at end of file
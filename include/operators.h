@@ -0,0 +1,98 @@
+﻿#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+using namespace std;
+
+// Операторы выражений. Текст оператора классифицируется один раз - при построении постфиксной
+// записи, дальше вычисление выбирает действие по значению перечисления, без сравнения строк.
+enum class OperatorKind : uint8_t
+{
+    None,           // Не оператор или неизвестный текст
+    Add, Sub, Mul, Div, IntDiv, Mod,
+    Eq, Ne, Lt, Gt, Le, Ge,
+    And, Or, Not,
+    Assign,
+    Count
+};
+
+struct OperatorInfo
+{
+    string_view text;
+    int precedence;         // Больше - связывает сильнее; -1 у None
+    bool rightAssociative;
+    uint8_t arity;
+    bool comparison;        // Результат - логическое значение (integer 0/1)
+};
+
+// Порядок строк совпадает с порядком OperatorKind (проверяется static_assert ниже)
+inline constexpr array<OperatorInfo, static_cast<size_t>(OperatorKind::Count)> OperatorTable = { {
+    { "",    -1, false, 0, false },
+    { "+",    4, false, 2, false },
+    { "-",    4, false, 2, false },
+    { "*",    5, false, 2, false },
+    { "/",    5, false, 2, false },
+    { "div",  5, false, 2, false },
+    { "mod",  5, false, 2, false },
+    { "=",    3, false, 2, true },
+    { "<>",   3, false, 2, true },
+    { "<",    3, false, 2, true },
+    { ">",    3, false, 2, true },
+    { "<=",   3, false, 2, true },
+    { ">=",   3, false, 2, true },
+    { "and",  2, false, 2, false },
+    { "or",   1, false, 2, false },
+    { "not",  6, true,  1, false },
+    { ":=",   0, true,  2, false },
+} };
+
+constexpr const OperatorInfo& operatorInfo(OperatorKind kind)
+{
+    return OperatorTable[static_cast<size_t>(kind)];
+}
+
+// Вид оператора по тексту (в нижнем регистре, как его выдает лексер); None, если текст не оператор
+constexpr OperatorKind ClassifyOperator(string_view text)
+{
+    for (size_t i = 1; i < OperatorTable.size(); ++i) {
+        if (OperatorTable[i].text == text)
+            return static_cast<OperatorKind>(i);
+    }
+    return OperatorKind::None;
+}
+
+static_assert(ClassifyOperator("+") == OperatorKind::Add, "operator table order");
+static_assert(ClassifyOperator("mod") == OperatorKind::Mod, "operator table order");
+static_assert(ClassifyOperator(">=") == OperatorKind::Ge, "operator table order");
+static_assert(ClassifyOperator("not") == OperatorKind::Not, "operator table order");
+static_assert(ClassifyOperator(":=") == OperatorKind::Assign, "operator table order");
+static_assert(ClassifyOperator("<<") == OperatorKind::None, "operator table order");
+
+// Сообщения об ошибках операций; одни и те же во всех способах выполнения
+inline constexpr const char* DivisionByZeroMessage = "Деление на ноль";
+inline constexpr const char* IntDivisionByZeroMessage = "Целочисленное деление на ноль";
+inline constexpr const char* ModByZeroMessage = "Вычисление остатка (mod) от деления на ноль";
+
+// div и mod для integer с теми же результатами, что и вещественный путь: div округляет
+// частное вниз, знак mod совпадает со знаком делимого. Частное MIN div -1 переполняется
+// по модулю 2^64, как и остальные integer-операции.
+inline long long IntDivide(long long lhs, long long rhs)
+{
+    if (rhs == 0) throw runtime_error(IntDivisionByZeroMessage);
+    if (rhs == -1) return static_cast<long long>(0 - static_cast<unsigned long long>(lhs));
+    long long quotient = lhs / rhs;
+    if (lhs % rhs != 0 && ((lhs < 0) != (rhs < 0)))
+        --quotient;
+    return quotient;
+}
+
+inline long long IntModulo(long long lhs, long long rhs)
+{
+    if (rhs == 0) throw runtime_error(ModByZeroMessage);
+    if (rhs == -1) return 0;
+    return lhs % rhs;
+}
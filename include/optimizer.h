@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include "hierarchical_list.h"
+#include "postfix.h"
+#include "tableManager.h"
+#include <vector>
+
+using namespace std;
+
+// Проход свертки констант над иерархическим списком (между Parser::BuildHList и выполнением).
+// Константы из CONST_SECTION вычисляются один раз так же, как это делает ProgramExecutor,
+// их использования в выражениях заменяются литералами, а подвыражения из одних констант
+// сворачиваются в одно значение. Выражения переписываются в node->expr, поэтому результат
+// виден в HLNodeToString. Подвыражения, вычисление которых дает ошибку (деление на ноль и т.п.),
+// а также некорректные выражения не изменяются: ошибка возникнет при выполнении в том же месте.
+class ConstantFolder
+{
+    // Узел дерева выражения, восстановленного из постфиксной записи
+    struct FoldNode
+    {
+        Lexeme lex;
+        int left = -1, right = -1;
+        bool constant = false;
+        bool folded = false;    // Значение получено сверткой или подстановкой, а не записано литералом
+        Value value;
+    };
+
+    TableManager consts;        // Объявленные имена; значения констант известны
+    PostfixExecutor postfix;
+    size_t rewritten = 0;
+
+    void declare(HLNode* section);
+    void foldBlock(HLNode* first);
+    void foldExpression(HLNode* node, size_t first, size_t last);
+    void emit(const vector<FoldNode>& nodes, int index, int parentPrecedence, bool isRight, vector<Lexeme>& out) const;
+
+public:
+    ConstantFolder() : postfix(&consts) {}
+
+    // Оптимизирует дерево на месте; возвращает число переписанных выражений.
+    // Некорректная программа не изменяется - ошибки сообщит исполнитель.
+    size_t Optimize(HLNode* head);
+};
+
+// Запись значения в виде числового литерала (double всегда с точкой или порядком)
+Lexeme ValueToLiteral(const Value& value);
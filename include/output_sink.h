@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// Число в том же виде, что и operator<< потока с настройками по умолчанию
+// (%g, 6 значащих цифр), но без локали и форматирования потока.
+// Записывает символы в [first, last) и возвращает конец записанного; 32 символов достаточно.
+char* FormatNumber(double value, char* first, char* last);
+
+// Буферизованный приемник вывода Write: текст накапливается в буфере и передается в поток
+// одним блоком при заполнении буфера, по явному flush (перед чтением ввода) и в конце программы.
+class OutputSink
+{
+    ostream* out;
+    string buffer;
+    size_t capacity;
+
+public:
+    static constexpr size_t DefaultCapacity = 64 * 1024;
+
+    explicit OutputSink(ostream& out = cout, size_t capacity = DefaultCapacity);
+    ~OutputSink();
+
+    OutputSink(const OutputSink&) = delete;
+    OutputSink& operator=(const OutputSink&) = delete;
+
+    void write(string_view text)
+    {
+        buffer.append(text.data(), text.size());
+        if (buffer.size() >= capacity)
+            flush();
+    }
+
+    void write(char c)
+    {
+        buffer.push_back(c);
+        if (buffer.size() >= capacity)
+            flush();
+    }
+
+    void writeNumber(double value);
+
+    // Передает накопленный текст в поток и сбрасывает сам поток
+    void flush();
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include "hierarchical_list.h"
+#include "flat_ast.h"
 #include "lexer.h"
 #include <vector>
 #include <stdexcept>
@@ -10,18 +11,29 @@
 
 using namespace std;
 
-class ParseError : public exception {
+class ParseError : public runtime_error {
 public:
-    ParseError(const char* const what) : exception(what) {};
+    ParseError(const char* const what) : runtime_error(what) {};
+};
+
+// Приемник узлов, которые строит Parser: иерархический список HLNode или плоское дерево FlatAST.
+// Узел обозначается номером в порядке создания (корень PROGRAM - 0)
+class ParseTreeSink {
+public:
+    virtual ~ParseTreeSink() = default;
+    virtual int create(NodeType type, vector<Lexeme> expr) = 0;
+    // Добавляет child в конец списка вложенных узлов parent за O(1)
+    virtual void append(int parent, int child) = 0;
 };
 
 class Parser {
 private:
-    vector<Lexeme> lexemes;
-    size_t pos = 0;
+    // Лексемы читаются из источника по одной: в памяти только текущая (просмотр вперед на одну)
+    LexemeSource* input = nullptr;
+    Lexeme current;
+    bool hasCurrent = false;        // false, когда лексемы закончились
 
-    HLNode* current = nullptr;
-    HLNode* root = nullptr;
+    ParseTreeSink* sink = nullptr;
 
     Lexeme& currentLex();
 
@@ -31,22 +43,37 @@ private:
 
     void advance();
 
-    HLNode* createNode(NodeType type, const vector<Lexeme>& expr = {});
+    bool atEnd() const { return !hasCurrent; }
+
+    int createNode(NodeType type, vector<Lexeme> expr = {});
 
     vector<Lexeme> collectUntil(const function<bool()>& predicate);
 
     vector<Lexeme> parseDeclaration();
 
 
-    void parseSection(HLNode* parent, NodeType sectionType);
+    // Разобранные узлы добавляются к родителю parent (номер узла в sink)
+    void parseProgram(LexemeSource& source, ParseTreeSink& target);
+    void parseSection(int parent, NodeType sectionType);
 
-    void parseStatement(HLNode* parent);
-    HLNode* parseFunctionCall();
-    HLNode* parseIf();
-    void parseBlock(HLNode* parent);
+    void parseStatement(int parent);
+    int parseFunctionCall();
+    void parseIf(int parent);    // Добавляет IF и связанный с ним ELSE
+    void parseBlock(int parent);
 
 public:
+    // Дерево из отдельно выделенных узлов; освобождается через delete корня
     HLNode* BuildHList(vector<Lexeme>& input);
+    // Дерево в регионе nodes; освобождается вместе с регионом (delete корня не вызывать)
+    HLNode* BuildHList(vector<Lexeme>& input, HLArena& nodes);
+    // То же дерево в плоском представлении
+    FlatAST BuildFlat(vector<Lexeme>& input);
+
+    // Разбор по мере чтения лексем из источника (например, LexemeStream над исходным текстом),
+    // без построения полного списка лексем
+    HLNode* BuildHList(LexemeSource& source);
+    HLNode* BuildHList(LexemeSource& source, HLArena& nodes);
+    FlatAST BuildFlat(LexemeSource& source);
 };
 
 std::string HLNodeToString(const HLNode* node, int level);
@@ -1,22 +1,58 @@
-#pragma once
+﻿#pragma once
 
 #include"hierarchical_list.h"
 #include"tableManager.h"
 #include "parser.h"
 #include "lexer.h"
+#include "jit.h"
+#include <memory>
 
 class PostfixExecutor
 {
 	TableManager* vartable;
 	vector<Lexeme> postfix;
+	CompiledExpr legacy;        // Выражение toPostfix/executePostfix (буферы переиспользуются)
+	vector<Value> evalStack;    // Стек вычисления; растет до наибольшей maxDepth и не освобождается
+	unique_ptr<JitCompiler> jit; // Компилятор в машинный код; nullptr - только интерпретатор
+	uint32_t jitThreshold = DefaultJitThreshold;
 
 	void buildPostfix(HLNode* node);
-	double evaluateOperation(const std::string& op, double lhs, double rhs);
-	bool evaluateCondition(const std::string& op, double lhs, double rhs);
-	double getValueFromLexeme(const Lexeme& lex);
-	bool isComparisonOperator(const std::string& op);
+	void appendPostfix(const Lexeme* first, const Lexeme* last, vector<Lexeme>& out);
+	void inferTypes(CompiledExpr& compiled);
+	Value evaluate(const CompiledExpr& compiled);
+	// Вычисление с проверками на каждом шаге: для несбалансированных выражений (сообщения об ошибках)
+	Value evaluateChecked(const CompiledExpr& compiled);
+	// Вызов машинного кода выражения
+	Value evaluateNative(const CompiledExpr& compiled);
+	Value getValueFromLexeme(const Lexeme& lex);
+	// Тип, в котором выполняется операция над операндами данных типов
+	static ValueType operationType(OperatorKind op, ValueType lhs, ValueType rhs);
+	// Операция выбирается по таблице обработчиков, индексированной видом оператора
+	static Value applyOperation(OperatorKind op, ValueType type, const Value& lhs, const Value& rhs);
 public:
 	PostfixExecutor(TableManager* varTablep);
+
+	// Выражение компилируется в машинный код на threshold-м вычислении: выражения, которые
+	// выполняются один-два раза, дешевле интерпретировать (компиляция стоит ~100 вычислений)
+	static constexpr uint32_t DefaultJitThreshold = 64;
+
+	// JIT выражений, компилируемых через compile (по умолчанию выключен); threshold 0 - сразу
+	// в compile. Если JIT нет в сборке (см. JitCompiler::available), вычисляет интерпретатор
+	void setJit(bool enabled, uint32_t threshold = DefaultJitThreshold);
+	bool jitEnabled() const { return jit != nullptr; }
 	void toPostfix(HLNode* start);
 	double executePostfix();
+
+	// Компиляция диапазона лексем [first, last) в постфиксную запись
+	void compile(const vector<Lexeme>& expr, size_t first, size_t last, CompiledExpr& out);
+	// Вычисление заранее скомпилированного выражения
+	double execute(const CompiledExpr& compiled);
+	// То же с сохранением типа результата (integer или double)
+	Value executeTyped(const CompiledExpr& compiled);
+
+	// Одна бинарная операция над готовыми значениями (для свертки констант)
+	Value applyOperator(const std::string& op, const Value& lhs, const Value& rhs);
+	Value applyOperator(OperatorKind op, const Value& lhs, const Value& rhs);
+	// Приоритет оператора; -1 для неизвестного
+	static int precedence(const std::string& op);
 };
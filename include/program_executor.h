@@ -4,6 +4,9 @@
 #include "lexer.h"             
 #include "postfix.h"           
 #include "tableManager.h"      
+#include "declaration.h"
+#include "output_sink.h"
+#include "input_source.h"
 #include <iostream>            
 #include <string>              
 #include <vector>              
@@ -16,6 +19,10 @@ class ProgramExecutor
 
     TableManager vartable;
     PostfixExecutor postfix; //  postfix    vartable  
+    OutputSink output;       //   Write;   Read    
+    StreamInputSource consoleInput; //  Read   - stdin
+    InputSource* input;
+    bool prompts = true;     //  "Enter value for x: "   Read
 
     void processNode(HLNode* node);
 
@@ -29,11 +36,34 @@ class ProgramExecutor
     //       ( )
     void executeBlockContents(HLNode* firstNode);
 
+    //   :      TableManager,
+    //            
+    void resolveSymbols(HLNode* firstNode);
+
+    //   (     ); -1,    
+    int slotOf(const Lexeme& lex) const;
+
     //        
-    double executeExpression(const vector<Lexeme>& expr);
+    // ( [first, last) ;         )
+    //   : integer-     double
+    Value executeExpression(HLNode* node, size_t first = 0, size_t last = std::string::npos);
+
+    //       ( )
+    Value evaluateOnce(const vector<Lexeme>& expr, size_t first, size_t last);
 
 public:
-    ProgramExecutor() : postfix(&vartable) {}
+    explicit ProgramExecutor(ostream& out = cout)
+        : postfix(&vartable), output(out), consoleInput(cin), input(&consoleInput) {}
+
+    //    Read;  ,   
+    void setInput(InputSource& source) { input = &source; }
+    //  :         Read
+    void setPrompts(bool enabled) { prompts = enabled; }
+    //      (. jit.h);     - 
+    void setJit(bool enabled, uint32_t threshold = PostfixExecutor::DefaultJitThreshold)
+    {
+        postfix.setJit(enabled, threshold);
+    }
 
     //      
     void Execute(HLNode* head);
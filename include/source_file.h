@@ -0,0 +1,37 @@
+﻿#pragma once
+
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// Текст программы для лексера. Обычный файл отображается в память (mmap) и отдается
+// лексеру как string_view без копирования; каналы, stdin ("-") и файлы, которые
+// не удалось отобразить, читаются через read() в один буфер.
+// Ошибки открытия и чтения сообщаются через runtime_error.
+class SourceFile
+{
+public:
+    enum class LoadMethod { Mapped, Read };
+
+    explicit SourceFile(const string& path);
+    ~SourceFile();
+
+    SourceFile(const SourceFile&) = delete;
+    SourceFile& operator=(const SourceFile&) = delete;
+
+    // Текст действителен, пока жив объект
+    string_view text() const { return view; }
+    LoadMethod method() const { return loadMethod; }
+
+private:
+    string_view view;
+    void* mapping = nullptr;    // Адрес отображения (nullptr, если текст в buffer)
+    size_t mappingSize = 0;
+    string buffer;
+    LoadMethod loadMethod = LoadMethod::Read;
+
+#ifndef _WIN32
+    void readAll(int fd, size_t sizeHint);
+#endif
+};
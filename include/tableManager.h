@@ -4,8 +4,10 @@
 #include <vector>
 #include <list>
 #include <functional>
+#include <utility>
 #include <stdexcept>
 #include <iostream> 
+#include "value.h"
 
 using namespace std;
 
@@ -154,13 +156,234 @@ public:
 
 
 
-class TableManager
+// -    (Robin Hood):      ,
+//     ,      maxLoad  .
+//    THashTableChain.
+template <typename TKey, typename TValue>
+class THashTableOpen
 {
-    THashTableChain<string, int> inttable;
-    THashTableChain<string, double> doubletable;
+    struct Node
+    {
+        TKey key;
+        TValue value;
+        bool isConstant;
+        size_t hash;
+        int distance = -1; //   "" ; -1 -  
+    };
+
+    static const size_t minCapacity = 16;
+    static constexpr double maxLoad = 0.85;
+
+    vector<Node> data;
+    size_t count = 0;
+    size_t mask;
+
+    size_t HashFunction(const TKey& key) const
+    {
+        return hash<TKey>()(key);
+    }
+
+    size_t FindIndex(const TKey& key) const
+    {
+        size_t h = HashFunction(key);
+        size_t index = h & mask;
+        for (int distance = 0; ; ++distance)
+        {
+            const Node& node = data[index];
+            // Robin Hood:       ,    ,  
+            if (node.distance < distance)
+                return data.size();
+            if (node.hash == h && node.key == key)
+                return index;
+            index = (index + 1) & mask;
+        }
+    }
+
+    Node* FindNode(const TKey& key)
+    {
+        size_t index = FindIndex(key);
+        return index < data.size() ? &data[index] : nullptr;
+    }
+
+    const Node* FindNode(const TKey& key) const
+    {
+        size_t index = FindIndex(key);
+        return index < data.size() ? &data[index] : nullptr;
+    }
+
+    //    :  ""    ""
+    void Place(Node node)
+    {
+        size_t index = node.hash & mask;
+        node.distance = 0;
+        for (;;)
+        {
+            Node& slot = data[index];
+            if (slot.distance < 0)
+            {
+                slot = std::move(node);
+                return;
+            }
+            if (slot.distance < node.distance)
+                std::swap(slot, node);
+            index = (index + 1) & mask;
+            ++node.distance;
+        }
+    }
+
+    void Grow()
+    {
+        vector<Node> old(data.size() * 2);
+        old.swap(data);
+        mask = data.size() - 1;
+        for (auto& node : old)
+        {
+            if (node.distance >= 0)
+                Place(std::move(node));
+        }
+    }
 
 public:
-    TableManager() = default;
+    THashTableOpen(size_t capacity = minCapacity)
+    {
+        if (capacity == 0)
+            throw std::invalid_argument("Capacity must be positive");
+        size_t size = minCapacity;
+        while (size < capacity)
+            size *= 2;
+        data.resize(size);
+        mask = size - 1;
+    }
+
+    string GetName() const
+    {
+        return "Hash Table Open (Robin Hood)";
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    size_t capacity() const
+    {
+        return data.size();
+    }
+
+    bool Insert(const TKey& key, const TValue& value, bool isConstant)
+    {
+        if (FindNode(key))
+            return false;
+        if (count + 1 > data.size() * maxLoad)
+            Grow();
+        Place({ key, value, isConstant, HashFunction(key) });
+        ++count;
+        return true;
+    }
+
+    void Delete(const TKey& key)
+    {
+        size_t index = FindIndex(key);
+        if (index == data.size())
+            return;
+        //    :       
+        size_t next = (index + 1) & mask;
+        while (data[next].distance > 0)
+        {
+            data[index] = std::move(data[next]);
+            --data[index].distance;
+            index = next;
+            next = (next + 1) & mask;
+        }
+        data[index] = Node();
+        --count;
+    }
+
+    TValue* Find(const TKey& key)
+    {
+        if (Node* node = FindNode(key))
+            return &node->value;
+        return nullptr;
+    }
+
+    const TValue* Find(const TKey& key) const
+    {
+        if (const Node* node = FindNode(key))
+            return &node->value;
+        return nullptr;
+    }
+
+    bool IsConstant(const TKey& key) const
+    {
+        if (const Node* node = FindNode(key))
+            return node->isConstant;
+        throw out_of_range("Key not found in hash table: " + key);
+    }
+
+    void Print() const
+    {
+        cout << "Hash Table Open Contents: " << endl;
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            if (data[i].distance < 0)
+                continue;
+            cout << "Slot " << i << " : Key: " << data[i].key << ", Value: " << data[i].value
+                << (data[i].isConstant ? " (const)" : " (var)") << endl;
+        }
+    }
+
+    TValue& operator[](const TKey& key)
+    {
+        if (Node* node = FindNode(key))
+        {
+            if (node->isConstant)
+            {
+                throw std::runtime_error("Attempt to modify constant: " + key);
+            }
+            return node->value;
+        }
+        throw out_of_range("Key not found in hash table: " + key);
+    }
+
+    const TValue& operator[](const TKey& key) const
+    {
+        if (const Node* node = FindNode(key))
+        {
+            return node->value;
+        }
+        throw out_of_range("Key not found in hash table: " + key);
+    }
+};
+
+//   :  ,    .
+//     ,  -      (),
+//   
+struct Symbol
+{
+    string name;
+    bool isInteger;
+    bool isConstant;
+    int intValue;
+    double doubleValue;
+
+    double value() const { return isInteger ? static_cast<double>(intValue) : doubleValue; }
+};
+
+//  .  -   ;
+//      -  table_manager.cpp.
+template <template <typename, typename> class THashTable>
+class TTableManager
+{
+    THashTable<string, int> table;  //  -> ;     ,    
+    vector<Symbol> symbols;
+
+    bool addSymbol(const Symbol& symbol);
+    //   ;       - out_of_range
+    Symbol& typed(const string& name, bool isInteger); //  :  - runtime_error
+    const Symbol& typed(const string& name, bool isInteger) const;
+
+public:
+    TTableManager() = default;
 
     bool addInt(const std::string& name, int val, bool isConstant);
     bool addDouble(const std::string& name, double val, bool isConstant);
@@ -171,8 +394,41 @@ public:
     const int& getIntConst(string name) const; //    
     const double& getDoubleConst(string name) const; //    
 
-    bool hasInt(const std::string& name) const { return inttable.Find(name) != nullptr; }
-    bool hasDouble(const std::string& name) const { return doubletable.Find(name) != nullptr; }
+    bool hasInt(const std::string& name) const { const Symbol* s = lookup(name); return s && s->isInteger; }
+    bool hasDouble(const std::string& name) const { const Symbol* s = lookup(name); return s && !s->isInteger; }
 
     bool isConstant(const std::string& name) const;
+
+    //   :   ,     nullptr
+    const Symbol* lookup(const std::string& name) const;
+    Symbol* lookup(const std::string& name);
+
+    //    ( ):       
+    int findSlot(const std::string& name) const; // -1,    
+    size_t slotCount() const { return symbols.size(); }
+    const Symbol& symbol(int slot) const { return symbols[slot]; }
+
+    double readSlot(int slot) const { return symbols[slot].value(); }
+
+    //       (integer )
+    void writeSlot(int slot, double val)
+    {
+        Symbol& s = symbols[slot];
+        if (s.isInteger)
+            s.intValue = static_cast<int>(val);
+        else
+            s.doubleValue = val;
+    }
+
+    void writeSlot(int slot, const Value& val)
+    {
+        Symbol& s = symbols[slot];
+        if (s.isInteger)
+            s.intValue = static_cast<int>(val.asInteger());
+        else
+            s.doubleValue = val.asDouble();
+    }
 };
+
+using TableManager = TTableManager<THashTableChain>;
+using OpenTableManager = TTableManager<THashTableOpen>;
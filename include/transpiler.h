@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include "hierarchical_list.h"
+#include "postfix.h"
+#include "tableManager.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Транслятор Pascal-- в C++: обходит иерархический список (PROGRAM, CONST_SECTION, VAR_SECTION,
+// MAIN_BLOCK, IF/ELSE, STATEMENT, CALL) и выдает самостоятельную единицу трансляции C++17,
+// которая компилируется системным компилятором без библиотек интерпретатора.
+//
+// Переменные становятся локальными переменными main типов int/double, константы вычисляются
+// при трансляции и подставляются как литералы, IF/ELSE - ветвлениями C++, Read/Write - вызовами
+// буферизованного ввода-вывода встроенной в программу поддержки (тот же формат чисел, что у Write
+// интерпретатора; параметр --no-prompt отключает приглашения Read).
+//
+// Семантика ProgramExecutor сохраняется: integer-выражения вычисляются в 64 битах с переполнением
+// по модулю 2^64, div/mod округляют так же, при присваивании integer-переменной значение усекается.
+// Операции выражения выполняются по порядку постфиксной записи, поэтому из нескольких ошибок
+// выражения возникает та же, что и в интерпретаторе. Ошибки времени выполнения (деление на ноль,
+// необъявленное имя, присваивание константе и т.п.) выводятся на месте узла: программа сбрасывает
+// накопленный вывод, печатает "error: <сообщение интерпретатора>" в stderr и завершается с кодом 1.
+// Ошибки объявлений, как и в BytecodeCompiler, выдаются исключением при трансляции.
+class CppTranspiler
+{
+    // Значение выражения в сгенерированном коде: литерал, переменная или временная константа
+    struct CppValue
+    {
+        string code;
+        ValueType type;
+    };
+
+    TableManager decltable;         // Все объявленные имена; значения констант известны при трансляции
+    PostfixExecutor postfix;        // Постфиксная запись и вывод типов выражений
+    string body;                    // Текст функции main
+    int indent = 0;
+    size_t temporaries = 0;         // Счетчик имен временных значений t1, t2, ...
+
+    void line(const string& text);
+    void emitFail(const string& message);
+    string temporary(ValueType type, const string& code);
+
+    void translateDeclarations(HLNode* section);
+    void translateBlock(HLNode* first);
+    HLNode* translateNode(HLNode* node);   // Возвращает следующий узел последовательности
+    void translateStatement(HLNode* node);
+    void translateIf(HLNode* node);
+    void translateCall(HLNode* node);
+    // Код вычисления лексем [first, last); при ошибке - вызов fail и значение 0
+    CppValue translateExpression(const vector<Lexeme>& expr, size_t first, size_t last);
+
+public:
+    CppTranspiler() : postfix(&decltable) {}
+
+    string Translate(HLNode* head);
+};
+
+// Строковый литерал C++ с экранированием (не-ASCII байты - восьмеричными escape-последовательностями)
+string CppStringLiteral(const string& text);
@@ -0,0 +1,29 @@
+﻿#pragma once
+
+#include <cstdint>
+
+// Тип значения выражения. Unknown - тип не удалось вывести при компиляции выражения
+// (например, имя не объявлено), тогда операция выбирается по фактическим значениям.
+enum class ValueType : uint8_t { Integer, Double, Unknown };
+
+// Значение с тегом типа. Целые хранятся в 64 битах, поэтому промежуточные результаты
+// integer-выражений не теряют точность (в отличие от double выше 2^53).
+struct Value
+{
+    ValueType type = ValueType::Double;
+    union
+    {
+        long long intValue;
+        double doubleValue = 0.0;
+    };
+
+    static Value integer(long long v) { Value r; r.type = ValueType::Integer; r.intValue = v; return r; }
+    static Value real(double v) { Value r; r.type = ValueType::Double; r.doubleValue = v; return r; }
+    // Значение неизвестного типа (нет значения)
+    static Value unknown() { Value r; r.type = ValueType::Unknown; return r; }
+
+    bool isInteger() const { return type == ValueType::Integer; }
+    double asDouble() const { return isInteger() ? static_cast<double>(intValue) : doubleValue; }
+    // Приведение к integer с усечением дробной части
+    long long asInteger() const { return isInteger() ? intValue : static_cast<long long>(doubleValue); }
+};
@@ -0,0 +1,735 @@
+﻿#include "bytecode.h"
+#include "declaration.h"
+#include "operators.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+// Прямой шитый код (computed goto) доступен в GCC/Clang, иначе - обычный switch
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(BYTECODE_NO_COMPUTED_GOTO)
+#define BYTECODE_COMPUTED_GOTO
+#endif
+
+// ---------------------------------------------------------------------------
+// Компилятор
+// ---------------------------------------------------------------------------
+
+int BytecodeCompiler::findSlot(const string& name) const {
+    auto it = slotIndex.find(name);
+    return it != slotIndex.end() ? it->second : -1;
+}
+
+int BytecodeCompiler::addConstant(double value) {
+    // Ключ - битовое представление: -0.0 и 0.0 остаются разными константами
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    auto inserted = constantIndex.emplace(bits, static_cast<int>(program.constants.size()));
+    if (inserted.second)
+        program.constants.push_back(value);
+    return inserted.first->second;
+}
+
+int BytecodeCompiler::addIntConstant(long long value) {
+    auto inserted = intConstantIndex.emplace(value, static_cast<int>(program.intConstants.size()));
+    if (inserted.second)
+        program.intConstants.push_back(value);
+    return inserted.first->second;
+}
+
+int BytecodeCompiler::addString(const string& text) {
+    program.strings.push_back(text);
+    return static_cast<int>(program.strings.size() - 1);
+}
+
+size_t BytecodeCompiler::emit(OpCode op, int32_t a) {
+    program.code.push_back({ op, a });
+    return program.code.size() - 1;
+}
+
+void BytecodeCompiler::emitFail(const string& message) {
+    emit(OpCode::Fail, addString(message));
+}
+
+void BytecodeCompiler::push(size_t count) {
+    depth += count;
+    if (depth > program.maxStack) program.maxStack = depth;
+}
+
+void BytecodeCompiler::pop(size_t count) {
+    depth -= count;
+}
+
+BytecodeProgram BytecodeCompiler::Compile(HLNode* head) {
+    // Те же проверки структуры, что и в ProgramExecutor::Execute
+    if (!head || head->type != NodeType::PROGRAM) {
+        throw std::runtime_error("Invalid program structure: Root node is missing or not of type PROGRAM.");
+    }
+
+    HLNode* mainBlock = nullptr;
+    for (HLNode* child = head->pdown; child; child = child->pnext) {
+        if (child->type == NodeType::MAIN_BLOCK) {
+            mainBlock = child;
+        }
+        else if (!mainBlock) {
+            if (child->type != NodeType::CONST_SECTION && child->type != NodeType::VAR_SECTION) {
+                throw std::runtime_error("Invalid program structure: Unexpected node type (" + std::string(NodeTypeToString(child->type)) + ") before MAIN_BLOCK.");
+            }
+        }
+        else {
+            throw std::runtime_error("Invalid program structure: Unexpected node type (" + std::string(NodeTypeToString(child->type)) + ") after MAIN_BLOCK.");
+        }
+    }
+    if (!mainBlock) {
+        throw std::runtime_error("Invalid program structure: MAIN_BLOCK is missing.");
+    }
+
+    program = BytecodeProgram();
+    slotIndex.clear();
+    constantIndex.clear();
+    intConstantIndex.clear();
+    depth = 0;
+
+    // Объявления обрабатываются при компиляции: переменные получают слоты,
+    // константы - значения, которые затем подставляются в код
+    for (HLNode* child = head->pdown; child != mainBlock; child = child->pnext) {
+        compileDeclarations(child);
+    }
+
+    compileBlock(mainBlock->pdown);
+    emit(OpCode::Halt);
+    return std::move(program);
+}
+
+void BytecodeCompiler::compileDeclarations(HLNode* section) {
+    for (HLNode* decl = section->pdown; decl; decl = decl->pnext) {
+        if (decl->type != NodeType::DECLARATION) {
+            throw std::runtime_error("Bytecode: unexpected node type (" + std::string(NodeTypeToString(decl->type)) + ") in declaration section.");
+        }
+
+        forEachDeclarationItem(decl, [&](const DeclarationItem& item) {
+            if (decltable.lookup(item.name)) {
+                throw std::runtime_error("Variable '" + item.name + "' is already declared.");
+            }
+
+            if (item.isConstant) {
+                // Значение вычисляется так же, как ProgramExecutor::handleDeclaration
+                CompiledExpr value;
+                postfix.compile(decl->expr, item.valueFirst, item.valueLast, value);
+                Value result = postfix.executeTyped(value);
+                if (item.isInteger())
+                    decltable.addInt(item.name, static_cast<int>(result.asInteger()), true);
+                else
+                    decltable.addDouble(item.name, result.asDouble(), true);
+            }
+            else {
+                // Переменные тоже заносятся в таблицу: выражения констант могут ссылаться на них
+                if (item.isInteger())
+                    decltable.addInt(item.name, 0, false);
+                else
+                    decltable.addDouble(item.name, 0.0, false);
+                slotIndex[item.name] = static_cast<int>(program.slots.size());
+                program.slots.push_back({ item.name, item.isInteger() });
+            }
+        });
+    }
+}
+
+void BytecodeCompiler::compileBlock(HLNode* first) {
+    HLNode* current = first;
+    while (current) {
+        current = compileNode(current);
+    }
+}
+
+HLNode* BytecodeCompiler::compileNode(HLNode* node) {
+    switch (node->type) {
+    case NodeType::STATEMENT:
+        compileStatement(node);
+        break;
+
+    case NodeType::IF:
+        compileIf(node);
+        // ELSE, следующий за IF, уже скомпилирован вместе с ним
+        if (node->pnext && node->pnext->type == NodeType::ELSE)
+            return node->pnext->pnext;
+        break;
+
+    case NodeType::ELSE:
+        // ELSE без предшествующего IF
+        if (node->pdown) emitFail("Attempted to process ELSE node directly.");
+        break;
+
+    case NodeType::CALL:
+        compileCall(node);
+        break;
+
+    case NodeType::PROGRAM:
+    case NodeType::MAIN_BLOCK:
+        compileBlock(node->pdown);
+        break;
+
+    default:
+        throw std::runtime_error("Bytecode: unsupported node type (" + std::string(NodeTypeToString(node->type)) + ") inside a block.");
+    }
+    return node->pnext;
+}
+
+void BytecodeCompiler::compileStatement(HLNode* node) {
+    const vector<Lexeme>& expr = node->expr;
+    if (expr.empty()) {
+        emitFail("Statement node has empty expression.");
+        return;
+    }
+
+    if (expr[0].type == LexemeType::Identifier && expr.size() > 1 &&
+        expr[1].type == LexemeType::Operator && expr[1].value == ":=") {
+        const string& varName = expr[0].value;
+
+        const Symbol* symbol = decltable.lookup(varName);
+        if (!symbol) {
+            emitFail("Attempt to assign to undeclared variable: " + varName);
+            return;
+        }
+        if (symbol->isConstant) {
+            emitFail("Attempt to assign to constant: '" + varName + "'");
+            return;
+        }
+
+        size_t rhsEnd = expr.size();
+        for (size_t i = 2; i < expr.size(); ++i) {
+            if (expr[i].type == LexemeType::Separator && expr[i].value == ";") {
+                rhsEnd = i;
+                break;
+            }
+        }
+        if (rhsEnd <= 2) {
+            emitFail("Assignment statement has empty right-hand side for variable: " + varName);
+            return;
+        }
+
+        int slot = findSlot(varName);
+        ValueType type = compileExpression(expr, 2, rhsEnd);
+        // Как TableManager::writeSlot: integer-переменная получает усеченное значение
+        if (program.slots[slot].isInteger) {
+            if (type != ValueType::Integer) emit(OpCode::Truncate);
+            emit(OpCode::StoreInt, slot);
+        }
+        else {
+            if (type == ValueType::Integer) emit(OpCode::ToReal);
+            emit(OpCode::Store, slot);
+        }
+        pop();
+    }
+    else {
+        // Выражение без присваивания: вычисляется (ошибки вычисления имеют приоритет), затем ошибка
+        compileExpression(expr, 0, expr.size());
+        pop();
+        emitFail("Expression used as statement without assignment.");
+    }
+}
+
+void BytecodeCompiler::compileIf(HLNode* node) {
+    if (node->expr.empty()) {
+        emitFail("IF node has empty condition expression.");
+        return;
+    }
+
+    ValueType type = compileExpression(node->expr, 0, node->expr.size());
+    size_t jumpToElse = emit(type == ValueType::Integer ? OpCode::JumpIfFalseInt : OpCode::JumpIfFalse);
+    pop();
+
+    compileBlock(node->pdown);
+
+    HLNode* elseNode = node->pnext;
+    if (elseNode && elseNode->type == NodeType::ELSE) {
+        size_t jumpToEnd = emit(OpCode::Jump);
+        program.code[jumpToElse].a = static_cast<int32_t>(program.code.size());
+        compileBlock(elseNode->pdown);
+        program.code[jumpToEnd].a = static_cast<int32_t>(program.code.size());
+    }
+    else {
+        program.code[jumpToElse].a = static_cast<int32_t>(program.code.size());
+    }
+}
+
+void BytecodeCompiler::compileCall(HLNode* node) {
+    if (node->expr.empty() || node->expr[0].type != LexemeType::Keyword) {
+        emitFail("Invalid CALL node: function name missing or not a keyword.");
+        return;
+    }
+
+    const string& functionName = node->expr[0].value;
+
+    if (functionName == "read") {
+        HLNode* argNode = node->pdown;
+        if (!argNode || argNode->pnext != nullptr ||
+            argNode->type != NodeType::STATEMENT || argNode->expr.size() != 1 || argNode->expr[0].type != LexemeType::Identifier) {
+            emitFail("Invalid Read statement format. Expected: read(identifier);");
+            return;
+        }
+        const string& varName = argNode->expr[0].value;
+
+        const Symbol* symbol = decltable.lookup(varName);
+        if (!symbol) {
+            emitFail("Variable '" + varName + "' not declared before Read.");
+            return;
+        }
+        if (symbol->isConstant) {
+            emitFail("Attempt to read into constant: '" + varName + "'");
+            return;
+        }
+        emit(OpCode::Read, findSlot(varName));
+    }
+    else if (functionName == "write") {
+        bool isFirstArg = true;
+        for (HLNode* arg = node->pdown; arg; arg = arg->pnext) {
+            if (arg->type != NodeType::STATEMENT) {
+                emitFail("Invalid Write statement format: expected STATEMENT node for argument.");
+                return;
+            }
+
+            if (!isFirstArg) emit(OpCode::WriteSpace);
+
+            if (!arg->expr.empty()) {
+                if (arg->expr.size() == 1 && arg->expr[0].type == LexemeType::StringLiteral) {
+                    emit(OpCode::WriteString, addString(arg->expr[0].value));
+                }
+                else {
+                    ValueType type = compileExpression(arg->expr, 0, arg->expr.size());
+                    emit(type == ValueType::Integer ? OpCode::WriteInt : OpCode::WriteValue);
+                    pop();
+                }
+            }
+            isFirstArg = false;
+        }
+        emit(OpCode::WriteLine);
+    }
+    else {
+        emitFail("Unsupported function call: '" + functionName + "'");
+    }
+}
+
+ValueType BytecodeCompiler::compileExpression(const vector<Lexeme>& expr, size_t first, size_t last) {
+    size_t base = depth;
+    vector<ValueType> types;    // Типы значений на стеке вычислений выражения
+
+    // Ошибка внутри выражения: дальше код недостижим, на стеке считаем одно значение
+    auto fail = [&](const string& message) {
+        emitFail(message);
+        depth = base;
+        push();
+        return ValueType::Double;
+    };
+
+    CompiledExpr rpn;
+    try {
+        postfix.compile(expr, first, last, rpn);
+    }
+    catch (const std::exception& e) {
+        return fail(e.what());
+    }
+
+    for (const Lexeme& lex : rpn.rpn) {
+        if (lex.type == LexemeType::Number) {
+            Value value;
+            try {
+                value = NumberValue(lex);
+            }
+            catch (const std::exception& e) {
+                return fail(e.what());
+            }
+            if (value.isInteger())
+                emit(OpCode::PushInt, addIntConstant(value.intValue));
+            else
+                emit(OpCode::PushConst, addConstant(value.doubleValue));
+            types.push_back(value.type);
+            push();
+        }
+        else if (lex.type == LexemeType::Identifier) {
+            const Symbol* symbol = decltable.lookup(lex.value);
+            if (!symbol) {
+                return fail("Identifier '" + lex.value + "' isn't declared.");
+            }
+            int slot = findSlot(lex.value);
+            if (slot >= 0)
+                emit(OpCode::Load, slot);
+            else if (symbol->isInteger) // Константа: значение известно при компиляции
+                emit(OpCode::PushInt, addIntConstant(symbol->intValue));
+            else
+                emit(OpCode::PushConst, addConstant(symbol->doubleValue));
+            types.push_back(symbol->isInteger ? ValueType::Integer : ValueType::Double);
+            push();
+        }
+        else if (lex.type == LexemeType::Operator) {
+            const string& op = lex.value;
+            OperatorKind kind = ClassifyOperator(op);
+            if (kind == OperatorKind::Assign) {
+                return fail("Assignment operator (:=) should be handled by ProgramExecutor, not PostfixExecutor directly.");
+            }
+            if (types.size() < 2) {
+                return fail(operatorInfo(kind).comparison ? "Not enough operands for comparison." : "Not enough operands for operation: " + op);
+            }
+
+            OpCode real, integer;
+            switch (kind) {
+            case OperatorKind::Add: real = OpCode::Add; integer = OpCode::AddInt; break;
+            case OperatorKind::Sub: real = OpCode::Sub; integer = OpCode::SubInt; break;
+            case OperatorKind::Mul: real = OpCode::Mul; integer = OpCode::MulInt; break;
+            case OperatorKind::Div: real = integer = OpCode::Div; break;
+            case OperatorKind::IntDiv: real = OpCode::IntDiv; integer = OpCode::IntDivInt; break;
+            case OperatorKind::Mod: real = OpCode::Mod; integer = OpCode::ModInt; break;
+            case OperatorKind::Eq: real = OpCode::Eq; integer = OpCode::EqInt; break;
+            case OperatorKind::Ne: real = OpCode::Ne; integer = OpCode::NeInt; break;
+            case OperatorKind::Lt: real = OpCode::Lt; integer = OpCode::LtInt; break;
+            case OperatorKind::Gt: real = OpCode::Gt; integer = OpCode::GtInt; break;
+            case OperatorKind::Le: real = OpCode::Le; integer = OpCode::LeInt; break;
+            case OperatorKind::Ge: real = OpCode::Ge; integer = OpCode::GeInt; break;
+            default:
+                return fail("Неизвестный оператор: " + op);
+            }
+
+            // Тип операции - как PostfixExecutor::operationType: "/" всегда вещественное
+            ValueType rhs = types.back(); types.pop_back();
+            ValueType lhs = types.back(); types.pop_back();
+            bool isInteger = kind != OperatorKind::Div && lhs == ValueType::Integer && rhs == ValueType::Integer;
+            if (!isInteger) {
+                if (lhs == ValueType::Integer) emit(OpCode::ToRealLhs);
+                if (rhs == ValueType::Integer) emit(OpCode::ToReal);
+            }
+            emit(isInteger ? integer : real);
+            types.push_back(isInteger || operatorInfo(kind).comparison ? ValueType::Integer : ValueType::Double);
+            pop();
+        }
+        else {
+            return fail("Unexpected lexeme type in postfix expression: " + lex.value);
+        }
+    }
+
+    // Пустое выражение дает 0, из нескольких значений результатом служит верхнее
+    if (types.empty()) {
+        emit(OpCode::PushConst, addConstant(0.0));
+        push();
+        return ValueType::Double;
+    }
+    if (types.size() > 1) {
+        emit(OpCode::Collapse, static_cast<int32_t>(types.size() - 1));
+        pop(types.size() - 1);
+    }
+    return types.back();
+}
+
+// ---------------------------------------------------------------------------
+// Интерпретатор
+// ---------------------------------------------------------------------------
+
+namespace
+{
+    typedef unsigned long long ull;
+}
+
+void BytecodeVM::Run(const BytecodeProgram& program) {
+    // Вывод, сделанный до ошибки выполнения, не должен теряться
+    try {
+        execute(program);
+    }
+    catch (...) {
+        output.flush();
+        throw;
+    }
+    output.flush();
+}
+
+void BytecodeVM::execute(const BytecodeProgram& program) {
+    slots.assign(program.slots.size(), VMCell{});  // 0 и 0.0 для переменных обоих типов
+    stack.resize(program.maxStack + 1);
+
+    const Instr* code = program.code.data();
+    const double* constants = program.constants.data();
+    const long long* intConstants = program.intConstants.data();
+    VMCell* vars = slots.data();
+    VMCell* sp = stack.data();      // Первая свободная ячейка стека
+    const Instr* pc = code;
+
+#ifdef BYTECODE_COMPUTED_GOTO
+    // Порядок меток совпадает с порядком OpCode
+    static void* const labels[] = {
+        &&op_PushConst, &&op_PushInt, &&op_Load, &&op_Store, &&op_StoreInt,
+        &&op_ToReal, &&op_ToRealLhs, &&op_Truncate, &&op_Collapse,
+        &&op_Add, &&op_Sub, &&op_Mul, &&op_Div, &&op_IntDiv, &&op_Mod,
+        &&op_Eq, &&op_Ne, &&op_Lt, &&op_Gt, &&op_Le, &&op_Ge,
+        &&op_AddInt, &&op_SubInt, &&op_MulInt, &&op_IntDivInt, &&op_ModInt,
+        &&op_EqInt, &&op_NeInt, &&op_LtInt, &&op_GtInt, &&op_LeInt, &&op_GeInt,
+        &&op_Jump, &&op_JumpIfFalse, &&op_JumpIfFalseInt,
+        &&op_WriteValue, &&op_WriteInt, &&op_WriteString, &&op_WriteSpace, &&op_WriteLine,
+        &&op_Read, &&op_Fail, &&op_Halt
+    };
+#define VM_CASE(name) op_##name:
+#define VM_DISPATCH() goto *labels[static_cast<size_t>(pc->op)]
+#define VM_NEXT() do { ++pc; VM_DISPATCH(); } while (0)
+    VM_DISPATCH();
+#else
+#define VM_CASE(name) case OpCode::name:
+#define VM_DISPATCH() continue
+#define VM_NEXT() { ++pc; continue; }
+    for (;;) {
+        switch (pc->op) {
+#endif
+
+    VM_CASE(PushConst)
+        (sp++)->d = constants[pc->a];
+        VM_NEXT();
+    VM_CASE(PushInt)
+        (sp++)->i = intConstants[pc->a];
+        VM_NEXT();
+    VM_CASE(Load)
+        *sp++ = vars[pc->a];
+        VM_NEXT();
+    VM_CASE(Store)
+        vars[pc->a] = *--sp;
+        VM_NEXT();
+    VM_CASE(StoreInt)
+        --sp;
+        vars[pc->a].i = static_cast<int>(sp->i);
+        VM_NEXT();
+    VM_CASE(ToReal)
+        sp[-1].d = static_cast<double>(sp[-1].i);
+        VM_NEXT();
+    VM_CASE(ToRealLhs)
+        sp[-2].d = static_cast<double>(sp[-2].i);
+        VM_NEXT();
+    VM_CASE(Truncate)
+        sp[-1].i = static_cast<long long>(sp[-1].d);
+        VM_NEXT();
+    VM_CASE(Collapse)
+        sp[-1 - pc->a] = sp[-1];
+        sp -= pc->a;
+        VM_NEXT();
+
+    VM_CASE(Add)
+        sp[-2].d = sp[-2].d + sp[-1].d; --sp;
+        VM_NEXT();
+    VM_CASE(Sub)
+        sp[-2].d = sp[-2].d - sp[-1].d; --sp;
+        VM_NEXT();
+    VM_CASE(Mul)
+        sp[-2].d = sp[-2].d * sp[-1].d; --sp;
+        VM_NEXT();
+    VM_CASE(Div)
+        if (sp[-1].d == 0) throw runtime_error(DivisionByZeroMessage);
+        sp[-2].d = sp[-2].d / sp[-1].d; --sp;
+        VM_NEXT();
+    VM_CASE(IntDiv)
+        if (sp[-1].d == 0) throw runtime_error(IntDivisionByZeroMessage);
+        sp[-2].d = floor(sp[-2].d / sp[-1].d); --sp;
+        VM_NEXT();
+    VM_CASE(Mod)
+        if (sp[-1].d == 0) throw runtime_error(ModByZeroMessage);
+        sp[-2].d = fmod(sp[-2].d, sp[-1].d); --sp;
+        VM_NEXT();
+
+    VM_CASE(Eq)
+        sp[-2].i = sp[-2].d == sp[-1].d; --sp;
+        VM_NEXT();
+    VM_CASE(Ne)
+        sp[-2].i = sp[-2].d != sp[-1].d; --sp;
+        VM_NEXT();
+    VM_CASE(Lt)
+        sp[-2].i = sp[-2].d < sp[-1].d; --sp;
+        VM_NEXT();
+    VM_CASE(Gt)
+        sp[-2].i = sp[-2].d > sp[-1].d; --sp;
+        VM_NEXT();
+    VM_CASE(Le)
+        sp[-2].i = sp[-2].d <= sp[-1].d; --sp;
+        VM_NEXT();
+    VM_CASE(Ge)
+        sp[-2].i = sp[-2].d >= sp[-1].d; --sp;
+        VM_NEXT();
+
+    // Сложение, вычитание и умножение integer - по модулю 2^64 (без неопределенного поведения)
+    VM_CASE(AddInt)
+        sp[-2].i = static_cast<long long>(static_cast<ull>(sp[-2].i) + static_cast<ull>(sp[-1].i)); --sp;
+        VM_NEXT();
+    VM_CASE(SubInt)
+        sp[-2].i = static_cast<long long>(static_cast<ull>(sp[-2].i) - static_cast<ull>(sp[-1].i)); --sp;
+        VM_NEXT();
+    VM_CASE(MulInt)
+        sp[-2].i = static_cast<long long>(static_cast<ull>(sp[-2].i) * static_cast<ull>(sp[-1].i)); --sp;
+        VM_NEXT();
+    VM_CASE(IntDivInt)
+        sp[-2].i = IntDivide(sp[-2].i, sp[-1].i); --sp;
+        VM_NEXT();
+    VM_CASE(ModInt)
+        sp[-2].i = IntModulo(sp[-2].i, sp[-1].i); --sp;
+        VM_NEXT();
+
+    VM_CASE(EqInt)
+        sp[-2].i = sp[-2].i == sp[-1].i; --sp;
+        VM_NEXT();
+    VM_CASE(NeInt)
+        sp[-2].i = sp[-2].i != sp[-1].i; --sp;
+        VM_NEXT();
+    VM_CASE(LtInt)
+        sp[-2].i = sp[-2].i < sp[-1].i; --sp;
+        VM_NEXT();
+    VM_CASE(GtInt)
+        sp[-2].i = sp[-2].i > sp[-1].i; --sp;
+        VM_NEXT();
+    VM_CASE(LeInt)
+        sp[-2].i = sp[-2].i <= sp[-1].i; --sp;
+        VM_NEXT();
+    VM_CASE(GeInt)
+        sp[-2].i = sp[-2].i >= sp[-1].i; --sp;
+        VM_NEXT();
+
+    VM_CASE(Jump)
+        pc = code + pc->a;
+        VM_DISPATCH();
+    VM_CASE(JumpIfFalse)
+        if ((--sp)->d == 0.0) {
+            pc = code + pc->a;
+            VM_DISPATCH();
+        }
+        VM_NEXT();
+    VM_CASE(JumpIfFalseInt)
+        if ((--sp)->i == 0) {
+            pc = code + pc->a;
+            VM_DISPATCH();
+        }
+        VM_NEXT();
+
+    VM_CASE(WriteValue)
+        output.writeNumber((--sp)->d);
+        VM_NEXT();
+    VM_CASE(WriteInt)
+        output.writeNumber(static_cast<double>((--sp)->i));
+        VM_NEXT();
+    VM_CASE(WriteString)
+        output.write(program.strings[pc->a]);
+        VM_NEXT();
+    VM_CASE(WriteSpace)
+        output.write(' ');
+        VM_NEXT();
+    VM_CASE(WriteLine)
+        output.write('\n');
+        VM_NEXT();
+
+    VM_CASE(Read)
+    {
+        const BytecodeSlot& slot = program.slots[pc->a];
+        double value;
+        if (prompts) {
+            output.write("Enter value for ");
+            output.write(slot.name);
+            output.write(": ");
+        }
+        if (prompts || input->interactive())
+            output.flush();
+        if (!input->next(value))
+            throw std::runtime_error("Invalid input for Read statement. Expected a number.");
+        if (slot.isInteger)
+            vars[pc->a].i = static_cast<int>(value);
+        else
+            vars[pc->a].d = value;
+        VM_NEXT();
+    }
+
+    VM_CASE(Fail)
+        throw std::runtime_error(program.strings[pc->a]);
+    VM_CASE(Halt)
+        return;
+
+#ifndef BYTECODE_COMPUTED_GOTO
+        }
+    }
+#endif
+#undef VM_CASE
+#undef VM_DISPATCH
+#undef VM_NEXT
+}
+
+void BytecodeExecutor::Execute(HLNode* head) {
+    BytecodeCompiler compiler;
+    BytecodeProgram program = compiler.Compile(head);
+    vm.Run(program);
+}
+
+// ---------------------------------------------------------------------------
+// Отладочный вывод
+// ---------------------------------------------------------------------------
+
+static const char* OpCodeToString(OpCode op) {
+    switch (op) {
+    case OpCode::PushConst: return "PUSH";
+    case OpCode::PushInt: return "PUSH_INT";
+    case OpCode::Load: return "LOAD";
+    case OpCode::Store: return "STORE";
+    case OpCode::StoreInt: return "STORE_INT";
+    case OpCode::ToReal: return "TO_REAL";
+    case OpCode::ToRealLhs: return "TO_REAL_LHS";
+    case OpCode::Truncate: return "TRUNCATE";
+    case OpCode::Collapse: return "COLLAPSE";
+    case OpCode::Add: return "ADD";
+    case OpCode::Sub: return "SUB";
+    case OpCode::Mul: return "MUL";
+    case OpCode::Div: return "DIV";
+    case OpCode::IntDiv: return "INT_DIV";
+    case OpCode::Mod: return "MOD";
+    case OpCode::Eq: return "EQ";
+    case OpCode::Ne: return "NE";
+    case OpCode::Lt: return "LT";
+    case OpCode::Gt: return "GT";
+    case OpCode::Le: return "LE";
+    case OpCode::Ge: return "GE";
+    case OpCode::AddInt: return "ADD_INT";
+    case OpCode::SubInt: return "SUB_INT";
+    case OpCode::MulInt: return "MUL_INT";
+    case OpCode::IntDivInt: return "INT_DIV_INT";
+    case OpCode::ModInt: return "MOD_INT";
+    case OpCode::EqInt: return "EQ_INT";
+    case OpCode::NeInt: return "NE_INT";
+    case OpCode::LtInt: return "LT_INT";
+    case OpCode::GtInt: return "GT_INT";
+    case OpCode::LeInt: return "LE_INT";
+    case OpCode::GeInt: return "GE_INT";
+    case OpCode::Jump: return "JUMP";
+    case OpCode::JumpIfFalse: return "JUMP_IF_FALSE";
+    case OpCode::JumpIfFalseInt: return "JUMP_IF_FALSE_INT";
+    case OpCode::WriteValue: return "WRITE";
+    case OpCode::WriteInt: return "WRITE_INT";
+    case OpCode::WriteString: return "WRITE_STR";
+    case OpCode::WriteSpace: return "WRITE_SPACE";
+    case OpCode::WriteLine: return "WRITE_LINE";
+    case OpCode::Read: return "READ";
+    case OpCode::Fail: return "FAIL";
+    case OpCode::Halt: return "HALT";
+    default: return "???";
+    }
+}
+
+string BytecodeToString(const BytecodeProgram& program) {
+    stringstream ss;
+    for (size_t i = 0; i < program.code.size(); ++i) {
+        const Instr& in = program.code[i];
+        ss << i << ": " << OpCodeToString(in.op);
+        switch (in.op) {
+        case OpCode::PushConst: ss << " " << program.constants[in.a]; break;
+        case OpCode::PushInt: ss << " " << program.intConstants[in.a]; break;
+        case OpCode::Load:
+        case OpCode::Store:
+        case OpCode::StoreInt:
+        case OpCode::Read: ss << " " << program.slots[in.a].name; break;
+        case OpCode::Collapse:
+        case OpCode::Jump:
+        case OpCode::JumpIfFalse:
+        case OpCode::JumpIfFalseInt: ss << " " << in.a; break;
+        case OpCode::WriteString:
+        case OpCode::Fail: ss << " \"" << program.strings[in.a] << "\""; break;
+        default: break;
+        }
+        ss << "\n";
+    }
+    return ss.str();
+}
@@ -0,0 +1,178 @@
+﻿#include "declaration.h"
+#include <stdexcept>
+
+// Разбор узла DECLARATION (используется исполнителями и проходами над деревом)
+void forEachDeclarationItem(const HLNode* node, const function<void(const DeclarationItem&)>& handler)
+{
+    if (node->expr.empty())
+    {
+        throw std::runtime_error("Declaration node has empty expression vector.");
+    }
+
+    size_t endIndex = node->expr.size();
+    if (!node->expr.empty() && node->expr.back().type == LexemeType::Separator && node->expr.back().value == ";")
+    {
+        endIndex = node->expr.size() - 1; // Не включаем последнюю ';' в обработку объявлений
+    }
+    else
+    {
+        endIndex = node->expr.size();
+    }
+
+    size_t currentPos = 0; // Текущая позиция в векторе лексем node->expr
+
+    // Итерируемся по лексемам в векторе expr до найденного конца объявления
+    while (currentPos < endIndex)
+    {
+        // 1. Ищем имя переменной/константы в текущем объявлении сегменте
+        std::string varName = "";
+        size_t nameStartIndex = currentPos; // Начало текущего сегмента объявления
+
+        // Пропускаем любые лексемы перед именем (не должно быть по корректной грамматике)
+        while (currentPos < endIndex && (node->expr[currentPos].type != LexemeType::Identifier) &&
+            !(node->expr[currentPos].type == LexemeType::Separator && node->expr[currentPos].value == ","))
+        {
+            currentPos++;
+        }
+
+        if (currentPos < endIndex && node->expr[currentPos].type == LexemeType::Identifier)
+        {
+            varName = node->expr[currentPos].value;
+            nameStartIndex = currentPos;
+            currentPos++; // Переходим после имени
+        }
+        else if (currentPos < endIndex && node->expr[currentPos].type == LexemeType::Separator && node->expr[currentPos].value == ",")
+        {
+            throw std::runtime_error("Syntax error in declaration: Unexpected ',' at position " + std::to_string(currentPos));
+        }
+        else
+        {
+            if (currentPos < endIndex)
+            {
+                throw std::runtime_error("Syntax error in declaration: Expected identifier at position " + std::to_string(currentPos));
+            }
+            break; // currentPos == endIndex, обработали все сегменты
+        }
+
+        // 2. Ищем оператор присваивания (=), двоеточие (:) и следующую запятую (,) или конец сегмента
+        size_t assignIndex = std::string::npos;
+        size_t typeIndex = std::string::npos;
+        size_t commaOrEndIndex = endIndex; // Индекс следующей ',' или endIndex
+
+        for (size_t i = currentPos; i < endIndex; ++i)
+        {
+            if (node->expr[i].type == LexemeType::Separator && node->expr[i].value == ",")
+            {
+                commaOrEndIndex = i; // Нашли конец текущего сегмента (запятую)
+                break;
+            }
+            if (node->expr[i].type == LexemeType::Operator && node->expr[i].value == "=" && assignIndex == std::string::npos)
+            {
+                assignIndex = i;
+            }
+            if (node->expr[i].type == LexemeType::Separator && node->expr[i].value == ":" && typeIndex == std::string::npos)
+            {
+                typeIndex = i;
+            }
+        }
+        // endOfCurrentDeclarationSegment теперь равен commaOrEndIndex
+
+       // 3. Определяем тип объявления и обрабатываем его
+
+        bool isConstant = (assignIndex != std::string::npos); // Это константа, если есть '='
+
+        // Если это константа (есть '=')
+        if (isConstant)
+        {
+            // Проверяем синтаксис константы: Имя [: Тип] = Значение ;
+            // Если указан тип (есть ':')
+            std::string typeName = "";
+            if (typeIndex != std::string::npos && typeIndex < assignIndex) // Если ':' находится перед '='
+            {
+                // Тип должен идти сразу после двоеточия
+                if (typeIndex + 1 >= assignIndex || node->expr[typeIndex + 1].type != LexemeType::VarType) {
+                    throw std::runtime_error("Syntax error in constant declaration: Missing or invalid type after ':' for '" + varName + "'");
+                }
+                typeName = node->expr[typeIndex + 1].value;
+                // Проверяем, что между типом и '=' нет лишних лексем
+                if (typeIndex + 2 < assignIndex) {
+                    throw std::runtime_error("Syntax error in constant declaration: Unexpected tokens between type and '=' for '" + varName + "'");
+                }
+            }
+            // Если тип не указан, typeIndex == std::string::npos или typeIndex > assignIndex (ошибка синтаксиса)
+            else if (typeIndex != std::string::npos) {
+                // Если ':' после '=', это ошибка синтаксиса
+                throw std::runtime_error("Syntax error in constant declaration: Type specifier after assignment for '" + varName + "'");
+            }
+
+            // Проверяем, есть ли что-то после '=' до конца сегмента (запятой или endIndex)
+            if (assignIndex + 1 >= commaOrEndIndex) {
+                throw std::runtime_error("Missing value/expression for constant declaration: " + varName);
+            }
+
+            // Тип, если указан, должен быть одним из поддерживаемых
+            if (!typeName.empty() && typeName != "integer" && typeName != "double") {
+                // Это не должно случиться, если Lexer правильно классифицирует VarType
+                throw std::runtime_error("Internal error: Unexpected VarType '" + typeName + "' for constant.");
+            }
+
+            // Значение константы - лексемы между '=' и концом сегмента
+            handler({ varName, typeName, true, assignIndex + 1, commaOrEndIndex });
+        }
+        // Если это не константа (нет '='), и найден разделитель типа (':')
+        else if (typeIndex != std::string::npos)
+        {
+            // Проверяем синтаксис переменной с типом: Имя : Тип ;
+             // Проверяем, что между именем и ':' нет лишних лексем
+            if (nameStartIndex + 1 < typeIndex) {
+                throw std::runtime_error("Syntax error in variable declaration: Unexpected tokens after name '" + varName + "' before ':'");
+            }
+
+            // Тип должен идти сразу после двоеточия
+            if (typeIndex + 1 >= commaOrEndIndex || node->expr[typeIndex + 1].type != LexemeType::VarType)
+            {
+                throw std::runtime_error("Missing or invalid type after ':' for variable: " + varName);
+            }
+            std::string typeName = node->expr[typeIndex + 1].value;
+
+            // Проверяем, что после типа нет ничего до конца сегмента (запятой или endIndex)
+            if (typeIndex + 2 < commaOrEndIndex)
+            {
+                throw std::runtime_error("Syntax error in variable declaration: Unexpected tokens after type for variable: " + varName);
+            }
+
+            if (typeName != "double" && typeName != "integer")
+            {
+                // Это не должно случиться
+                throw std::runtime_error("Unsupported variable type: " + typeName);
+            }
+            handler({ varName, typeName, false, 0, 0 });
+        }
+        // Если это не константа, нет типа - это переменная без явного типа (предполагается int)
+        else
+        {
+            // Проверяем, что после имени до конца сегмента (запятой или endIndex) нет никаких лексем
+            if (nameStartIndex + 1 < commaOrEndIndex)
+            {
+                throw std::runtime_error("Syntax error in variable declaration: Unexpected token after variable name '" + varName + "'");
+            }
+            handler({ varName, "", false, 0, 0 }); // Переменная без типа (int по умолчанию)
+        }
+
+        // 4. Переходим к началу следующего сегмента объявления (после текущего сегмента и разделителя ',')
+        currentPos = commaOrEndIndex;
+        // Если текущая позиция указывает на запятую, переходим после нее.
+        if (currentPos < endIndex && node->expr[currentPos].type == LexemeType::Separator && node->expr[currentPos].value == ",")
+        {
+            currentPos++; // Пропускаем запятую
+        }
+    }
+
+    // Проверяем, что после обработки всех сегментов мы действительно достигли endIndex
+    if (currentPos != endIndex)
+    {
+        // Это должно случиться, если есть лишние лексемы после последней запятой,
+        // которые не были частью сегмента.
+        throw std::runtime_error("Syntax error in declaration: Unexpected tokens after last variable/constant declaration.");
+    }
+}
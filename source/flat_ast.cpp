@@ -0,0 +1,103 @@
+﻿#include "flat_ast.h"
+#include "parser.h"
+#include <sstream>
+#include <iterator>
+#include <utility>
+
+int FlatAST::addNode(NodeType kind, const Lexeme* first, const Lexeme* last) {
+    kinds.push_back(kind);
+    firstChild.push_back(None);
+    nextSibling.push_back(None);
+    exprFirst.push_back(static_cast<uint32_t>(tokens.size()));
+    tokens.insert(tokens.end(), first, last);
+    exprLast.push_back(static_cast<uint32_t>(tokens.size()));
+    return static_cast<int>(kinds.size() - 1);
+}
+
+int FlatAST::addNode(NodeType kind, vector<Lexeme>&& expr) {
+    kinds.push_back(kind);
+    firstChild.push_back(None);
+    nextSibling.push_back(None);
+    exprFirst.push_back(static_cast<uint32_t>(tokens.size()));
+    tokens.insert(tokens.end(), make_move_iterator(expr.begin()), make_move_iterator(expr.end()));
+    exprLast.push_back(static_cast<uint32_t>(tokens.size()));
+    return static_cast<int>(kinds.size() - 1);
+}
+
+FlatAST FlattenHList(const HLNode* root) {
+    FlatAST ast;
+    if (!root)
+        return ast;
+
+    // Обход в глубину: узел, затем его дети, затем следующий узел уровня.
+    // В стеке - узел HLNode и индекс плоского узла, к которому его надо привязать
+    struct Pending
+    {
+        const HLNode* node;
+        int parent;     // Для первого ребенка - индекс родителя, иначе None
+        int previous;   // Для следующего узла уровня - индекс предыдущего, иначе None
+    };
+    vector<Pending> stack{ { root, FlatAST::None, FlatAST::None } };
+
+    while (!stack.empty()) {
+        Pending item = stack.back();
+        stack.pop_back();
+
+        const vector<Lexeme>& expr = item.node->expr;
+        int index = ast.addNode(item.node->type, expr.data(), expr.data() + expr.size());
+        if (item.parent != FlatAST::None)
+            ast.firstChild[item.parent] = index;
+        if (item.previous != FlatAST::None)
+            ast.nextSibling[item.previous] = index;
+
+        // pnext кладется первым, чтобы вся ветка pdown была выписана раньше него
+        if (item.node->pnext)
+            stack.push_back({ item.node->pnext, FlatAST::None, index });
+        if (item.node->pdown)
+            stack.push_back({ item.node->pdown, index, FlatAST::None });
+    }
+    return ast;
+}
+
+HLNode* ExpandFlatAST(const FlatAST& ast, HLArena* arena) {
+    if (ast.empty())
+        return nullptr;
+
+    vector<HLNode*> nodes(ast.size());
+    for (size_t i = 0; i < ast.size(); ++i) {
+        int index = static_cast<int>(i);
+        nodes[i] = arena ? arena->create(ast.kinds[i], ast.expr(index)) : new HLNode(ast.kinds[i], ast.expr(index));
+    }
+    for (size_t i = 0; i < ast.size(); ++i) {
+        if (ast.firstChild[i] != FlatAST::None)
+            nodes[i]->pdown = nodes[ast.firstChild[i]];
+        if (ast.nextSibling[i] != FlatAST::None)
+            nodes[i]->pnext = nodes[ast.nextSibling[i]];
+    }
+    return nodes[0];
+}
+
+std::string HLNodeToString(const FlatAST& ast, int node, int level) {
+    std::stringstream ss;
+    vector<pair<int, int>> stack; // Узел и его уровень вложенности
+    if (node >= 0 && static_cast<size_t>(node) < ast.size())
+        stack.push_back({ node, level });
+
+    while (!stack.empty()) {
+        auto [index, depth] = stack.back();
+        stack.pop_back();
+
+        ss << std::string(depth * 2, ' ') << "[" << NodeTypeToString(ast.kinds[index]);
+        if (ast.exprSize(index) > 0) {
+            ss << ": ";
+            for (const Lexeme* lex = ast.exprBegin(index); lex != ast.exprEnd(index); ++lex) ss << lex->value << " ";
+        }
+        ss << "]\n";
+
+        if (ast.nextSibling[index] != FlatAST::None)
+            stack.push_back({ ast.nextSibling[index], depth });
+        if (ast.firstChild[index] != FlatAST::None)
+            stack.push_back({ ast.firstChild[index], depth + 1 });
+    }
+    return ss.str();
+}
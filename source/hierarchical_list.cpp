@@ -28,7 +28,62 @@ void HLNode::addChild(HLNode* child) {
     }
 }
 
+HLNodeAppender::HLNodeAppender(HLNode* parent) : parent(parent) {
+    for (HLNode* node = parent->pdown; node; node = node->pnext)
+        tail = node;
+}
+
+void HLNodeAppender::append(HLNode* child) {
+    if (!child) return;
+
+    if (tail)
+        tail->pnext = child;
+    else
+        parent->pdown = child;
+
+    tail = child;
+    while (tail->pnext)
+        tail = tail->pnext;
+}
+
 HLNode::~HLNode() {
-    delete pdown; // Удалит все узлы в ветке pdown
-    delete pnext; // Удалит все узлы в ветке pnext
-}
\ No newline at end of file
+    delete compiled;
+
+    // Узлы отцепляются от связей до удаления, поэтому их деструкторы не уходят в рекурсию
+    vector<HLNode*> pending;
+    if (pdown) pending.push_back(pdown);
+    if (pnext) pending.push_back(pnext);
+    pdown = pnext = nullptr;
+
+    while (!pending.empty()) {
+        HLNode* node = pending.back();
+        pending.pop_back();
+        if (node->pdown) pending.push_back(node->pdown);
+        if (node->pnext) pending.push_back(node->pnext);
+        node->pdown = node->pnext = nullptr;
+        delete node;
+    }
+}
+
+HLNode* HLArena::create(NodeType type, vector<Lexeme> expr) {
+    if (used == BlockSize) {
+        blocks.emplace_back(new Slot[BlockSize]);
+        used = 0;
+    }
+    HLNode* node = new (&blocks.back()[used]) HLNode(type, std::move(expr));
+    ++used;
+    ++count;
+    return node;
+}
+
+HLArena::~HLArena() {
+    // Связи между узлами региона не обходятся: каждый узел разрушается на своем месте
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        size_t inBlock = b + 1 == blocks.size() ? used : BlockSize;
+        for (size_t i = 0; i < inBlock; ++i) {
+            HLNode* node = reinterpret_cast<HLNode*>(&blocks[b][i]);
+            node->pdown = node->pnext = nullptr;
+            node->~HLNode();
+        }
+    }
+}
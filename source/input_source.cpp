@@ -0,0 +1,89 @@
+﻿#include "input_source.h"
+
+#include <charconv>
+
+namespace
+{
+    // Пробельные символы "C"-локали без обращения к локали
+    bool isSpace(int c)
+    {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    // Длиннее не бывает ни одна запись double, которую стоит разбирать
+    const size_t MaxNumberLength = 128;
+}
+
+bool ParseNumber(const char* first, const char* last, double& value)
+{
+    // operator>> допускает знак '+', from_chars - нет
+    if (first != last && *first == '+') {
+        ++first;
+        if (first != last && *first == '-')
+            return false;
+    }
+    // from_chars принимает inf и nan, operator>> - нет: число начинается с цифры или точки
+    const char* digits = first != last && *first == '-' ? first + 1 : first;
+    if (digits == last || !((*digits >= '0' && *digits <= '9') || *digits == '.'))
+        return false;
+    auto [ptr, ec] = from_chars(first, last, value);
+    return ec == errc() && ptr == last;
+}
+
+bool StreamInputSource::next(double& value)
+{
+    streambuf* buffer = stream.rdbuf();
+    if (!buffer)
+        return false;
+    int c = buffer->sgetc();
+    while (c != char_traits<char>::eof() && isSpace(c))
+        c = buffer->snextc();
+
+    char token[MaxNumberLength];
+    size_t length = 0;
+    bool tooLong = false;
+    while (c != char_traits<char>::eof() && !isSpace(c)) {
+        if (length < sizeof(token))
+            token[length++] = static_cast<char>(c);
+        else
+            tooLong = true;
+        c = buffer->snextc();
+    }
+    if (length == 0)
+        return false;
+
+    if (!tooLong && ParseNumber(token, token + length, value))
+        return true;
+    while (c != char_traits<char>::eof() && c != '\n')
+        c = buffer->snextc();
+    if (c == '\n')
+        buffer->sbumpc();
+    return false;
+}
+
+bool BufferInputSource::next(double& value)
+{
+    while (pos != end && isSpace(*pos))
+        ++pos;
+    const char* first = pos;
+    while (pos != end && !isSpace(*pos))
+        ++pos;
+    if (first == pos)
+        return false;
+
+    if (ParseNumber(first, pos, value))
+        return true;
+    while (pos != end && *pos != '\n')
+        ++pos;
+    if (pos != end)
+        ++pos;
+    return false;
+}
+
+bool ArrayInputSource::next(double& value)
+{
+    if (pos == values.size())
+        return false;
+    value = values[pos++];
+    return true;
+}
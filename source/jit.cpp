@@ -0,0 +1,468 @@
+﻿#include "jit.h"
+#include "tableManager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+
+#if !defined(PASCAL_NO_JIT) && (defined(__x86_64__) || defined(_M_X64))
+#define PASCAL_JIT_X64
+#endif
+
+#ifdef PASCAL_JIT_X64
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+#endif
+
+namespace
+{
+    atomic<uint64_t> nextGeneration{ 1 };
+}
+
+#ifdef PASCAL_JIT_X64
+
+namespace
+{
+    const size_t ChunkSize = 64 * 1024;
+    const size_t MaxDepth = 4096; // Кадр выражения лежит на машинном стеке; более глубокие - интерпретатору
+
+    // Вещественные div и mod вызывают функции библиотеки (в SSE2 нет округления вниз)
+    double jitFloor(double x) { return floor(x); }
+    double jitFmod(double a, double b) { return fmod(a, b); }
+
+    uint8_t* allocatePages(size_t size)
+    {
+#ifdef _WIN32
+        return static_cast<uint8_t*>(VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+#else
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return p == MAP_FAILED ? nullptr : static_cast<uint8_t*>(p);
+#endif
+    }
+
+    // Страницы либо доступны для записи, либо исполняемы (W^X)
+    bool protectPages(uint8_t* data, size_t size, bool executable)
+    {
+#ifdef _WIN32
+        DWORD old;
+        if (!VirtualProtect(data, size, executable ? PAGE_EXECUTE_READ : PAGE_READWRITE, &old))
+            return false;
+        if (executable)
+            FlushInstructionCache(GetCurrentProcess(), data, size);
+        return true;
+#else
+        return mprotect(data, size, executable ? PROT_READ | PROT_EXEC : PROT_READ | PROT_WRITE) == 0;
+#endif
+    }
+
+    void freePages(uint8_t* data, size_t size)
+    {
+#ifdef _WIN32
+        (void)size;
+        VirtualFree(data, 0, MEM_RELEASE);
+#else
+        munmap(data, size);
+#endif
+    }
+
+    // Смещения полей Symbol (тип не standard-layout, поэтому без offsetof)
+    struct SymbolLayout
+    {
+        int32_t intValue;
+        int32_t doubleValue;
+    };
+
+    SymbolLayout symbolLayout()
+    {
+        static const SymbolLayout layout = [] {
+            Symbol s{};
+            const char* base = reinterpret_cast<const char*>(&s);
+            return SymbolLayout{
+                static_cast<int32_t>(reinterpret_cast<const char*>(&s.intValue) - base),
+                static_cast<int32_t>(reinterpret_cast<const char*>(&s.doubleValue) - base) };
+        }();
+        return layout;
+    }
+
+    // Генератор кода выражения. Стек вычисления - в кадре функции: элемент d лежит в [rsp + 32 + 8*d]
+    // (первые 32 байта - shadow space для вызовов в Win64). rbx - таблица символов, r12 - адрес результата,
+    // rax/rcx/rdx и xmm0-xmm2 - рабочие регистры одной операции.
+    class Emitter
+    {
+        vector<uint8_t>& code;
+        vector<pair<size_t, JitStatus>> errorJumps; // Переходы к выходу с ошибкой
+
+    public:
+        explicit Emitter(vector<uint8_t>& code) : code(code) {}
+
+        void bytes(initializer_list<uint8_t> list) { code.insert(code.end(), list); }
+
+        void imm32(int32_t value)
+        {
+            for (int i = 0; i < 4; ++i)
+                code.push_back(static_cast<uint8_t>(static_cast<uint32_t>(value) >> (8 * i)));
+        }
+
+        void imm64(uint64_t value)
+        {
+            for (int i = 0; i < 8; ++i)
+                code.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+
+        // Операнд [rsp + disp32] элемента стека с полем reg в ModRM
+        void stackSlot(uint8_t reg, size_t depth)
+        {
+            bytes({ static_cast<uint8_t>(0x84 | (reg << 3)), 0x24 });
+            imm32(static_cast<int32_t>(32 + 8 * depth));
+        }
+
+        // Короткий переход вперед: позиция смещения, которое заполняет land
+        size_t jump8(uint8_t opcode)
+        {
+            bytes({ opcode, 0 });
+            return code.size() - 1;
+        }
+
+        void land(size_t at) { code[at] = static_cast<uint8_t>(code.size() - (at + 1)); }
+
+        void jumpOnError(initializer_list<uint8_t> opcode, JitStatus status)
+        {
+            bytes(opcode);
+            errorJumps.emplace_back(code.size(), status);
+            imm32(0);
+        }
+
+        void patch32(size_t at, size_t target)
+        {
+            int32_t rel = static_cast<int32_t>(static_cast<long long>(target) - static_cast<long long>(at + 4));
+            memcpy(&code[at], &rel, sizeof(rel));
+        }
+
+        // Заглушки ошибок: код статуса в eax и переход на общий эпилог exitLabel
+        void errorStubs(size_t exitLabel)
+        {
+            for (const auto& [at, status] : errorJumps) {
+                patch32(at, code.size());
+                bytes({ 0xB8 });                    // mov eax, status
+                imm32(status);
+                bytes({ 0xE9 });                    // jmp exit
+                size_t jump = code.size();
+                imm32(0);
+                patch32(jump, exitLabel);
+            }
+        }
+
+        // Значение элемента стека в xmm0/xmm1 с переводом integer в double
+        void loadDouble(uint8_t xmm, size_t depth, ValueType type)
+        {
+            if (type == ValueType::Integer)
+                bytes({ 0xF2, 0x48, 0x0F, 0x2A });  // cvtsi2sd xmm, qword [slot]
+            else
+                bytes({ 0xF2, 0x0F, 0x10 });        // movsd xmm, [slot]
+            stackSlot(xmm, depth);
+        }
+
+        // Ошибка, если xmm1 == 0 (NaN нулем не считается, как и в интерпретаторе)
+        void checkRealDivisor(JitStatus status)
+        {
+            bytes({ 0x66, 0x0F, 0x57, 0xD2 });      // xorpd xmm2, xmm2
+            bytes({ 0x66, 0x0F, 0x2E, 0xCA });      // ucomisd xmm1, xmm2
+            size_t unordered = jump8(0x7A);         // jp ok
+            jumpOnError({ 0x0F, 0x84 }, status);    // je error
+            land(unordered);
+        }
+
+        void callHelper(const void* function)
+        {
+            bytes({ 0x48, 0xB8 });                  // mov rax, function
+            imm64(reinterpret_cast<uint64_t>(function));
+            bytes({ 0xFF, 0xD0 });                  // call rax
+        }
+
+        // Целочисленная операция над элементами lhs и lhs + 1, результат - в элементе lhs
+        void integerOperation(OperatorKind op, size_t lhs)
+        {
+            bytes({ 0x48, 0x8B }); stackSlot(0, lhs);      // mov rax, [lhs]
+            bytes({ 0x48, 0x8B }); stackSlot(1, lhs + 1);  // mov rcx, [rhs]
+
+            switch (op) {
+            case OperatorKind::Add: bytes({ 0x48, 0x01, 0xC8 }); break;          // add rax, rcx
+            case OperatorKind::Sub: bytes({ 0x48, 0x29, 0xC8 }); break;          // sub rax, rcx
+            case OperatorKind::Mul: bytes({ 0x48, 0x0F, 0xAF, 0xC1 }); break;    // imul rax, rcx
+            case OperatorKind::IntDiv:
+            case OperatorKind::Mod: {
+                bool divide = op == OperatorKind::IntDiv;
+                bytes({ 0x48, 0x85, 0xC9 });                                      // test rcx, rcx
+                jumpOnError({ 0x0F, 0x84 }, divide ? JitIntDivisionByZero : JitModByZero);
+                // Делитель -1 отдельно: idiv на LLONG_MIN / -1 вызывает исключение процессора
+                bytes({ 0x48, 0x83, 0xF9, 0xFF });                                // cmp rcx, -1
+                size_t general = jump8(0x75);                                     // jne general
+                if (divide)
+                    bytes({ 0x48, 0xF7, 0xD8 });                                  // neg rax
+                else
+                    bytes({ 0x31, 0xC0 });                                        // xor eax, eax
+                size_t done = jump8(0xEB);                                        // jmp done
+                land(general);
+                bytes({ 0x48, 0x99 });                                            // cqo
+                bytes({ 0x48, 0xF7, 0xF9 });                                      // idiv rcx
+                if (divide) {
+                    // Частное округляется вниз: при ненулевом остатке другого знака, чем делитель, - минус 1
+                    bytes({ 0x48, 0x85, 0xD2 });                                  // test rdx, rdx
+                    size_t exact = jump8(0x74);                                   // je done
+                    bytes({ 0x48, 0x31, 0xCA });                                  // xor rdx, rcx
+                    size_t sameSign = jump8(0x79);                                // jns done
+                    bytes({ 0x48, 0xFF, 0xC8 });                                  // dec rax
+                    land(exact);
+                    land(sameSign);
+                }
+                else {
+                    bytes({ 0x48, 0x89, 0xD0 });                                  // mov rax, rdx
+                }
+                land(done);
+                break;
+            }
+            default: {
+                static const uint8_t setcc[] = { 0x94, 0x95, 0x9C, 0x9F, 0x9E, 0x9D }; // Eq Ne Lt Gt Le Ge
+                bytes({ 0x48, 0x39, 0xC8 });                                      // cmp rax, rcx
+                bytes({ 0x0F, setcc[static_cast<size_t>(op) - static_cast<size_t>(OperatorKind::Eq)], 0xC0 });
+                bytes({ 0x0F, 0xB6, 0xC0 });                                      // movzx eax, al
+                break;
+            }
+            }
+
+            bytes({ 0x48, 0x89 }); stackSlot(0, lhs);      // mov [lhs], rax
+        }
+
+        // Вещественная операция (сравнение дает integer 0/1)
+        void realOperation(OperatorKind op, size_t lhs, ValueType lhsType, ValueType rhsType)
+        {
+            loadDouble(0, lhs, lhsType);
+            loadDouble(1, lhs + 1, rhsType);
+
+            bool comparison = false;
+            switch (op) {
+            case OperatorKind::Add: bytes({ 0xF2, 0x0F, 0x58, 0xC1 }); break;    // addsd xmm0, xmm1
+            case OperatorKind::Sub: bytes({ 0xF2, 0x0F, 0x5C, 0xC1 }); break;    // subsd xmm0, xmm1
+            case OperatorKind::Mul: bytes({ 0xF2, 0x0F, 0x59, 0xC1 }); break;    // mulsd xmm0, xmm1
+            case OperatorKind::Div:
+                checkRealDivisor(JitDivisionByZero);
+                bytes({ 0xF2, 0x0F, 0x5E, 0xC1 });                                // divsd xmm0, xmm1
+                break;
+            case OperatorKind::IntDiv:
+                checkRealDivisor(JitIntDivisionByZero);
+                bytes({ 0xF2, 0x0F, 0x5E, 0xC1 });                                // divsd xmm0, xmm1
+                callHelper(reinterpret_cast<const void*>(&jitFloor));
+                break;
+            case OperatorKind::Mod:
+                checkRealDivisor(JitModByZero);
+                callHelper(reinterpret_cast<const void*>(&jitFmod));
+                break;
+            case OperatorKind::Eq:
+                bytes({ 0x66, 0x0F, 0x2E, 0xC1 });  // ucomisd xmm0, xmm1
+                bytes({ 0x0F, 0x94, 0xC0 });        // sete al
+                bytes({ 0x0F, 0x9B, 0xC1 });        // setnp cl
+                bytes({ 0x20, 0xC8 });              // and al, cl
+                comparison = true;
+                break;
+            case OperatorKind::Ne:
+                bytes({ 0x66, 0x0F, 0x2E, 0xC1 });  // ucomisd xmm0, xmm1
+                bytes({ 0x0F, 0x95, 0xC0 });        // setne al
+                bytes({ 0x0F, 0x9A, 0xC1 });        // setp cl
+                bytes({ 0x08, 0xC8 });              // or al, cl
+                comparison = true;
+                break;
+            default: {
+                // a < b и a <= b проверяются как b > a и b >= a: seta/setae ложны для NaN
+                bool swap = op == OperatorKind::Lt || op == OperatorKind::Le;
+                bool orEqual = op == OperatorKind::Le || op == OperatorKind::Ge;
+                bytes({ 0x66, 0x0F, 0x2E, static_cast<uint8_t>(swap ? 0xC8 : 0xC1) }); // ucomisd
+                bytes({ 0x0F, static_cast<uint8_t>(orEqual ? 0x93 : 0x97), 0xC0 });     // setae/seta al
+                comparison = true;
+                break;
+            }
+            }
+
+            if (comparison) {
+                bytes({ 0x0F, 0xB6, 0xC0 });                    // movzx eax, al
+                bytes({ 0x48, 0x89 }); stackSlot(0, lhs);      // mov [lhs], rax
+            }
+            else {
+                bytes({ 0xF2, 0x0F, 0x11 }); stackSlot(0, lhs); // movsd [lhs], xmm0
+            }
+        }
+    };
+
+    bool supported(OperatorKind op)
+    {
+        return op >= OperatorKind::Add && op <= OperatorKind::Ge;
+    }
+
+    // Код функции выражения; false - в выражении есть то, что компилируется только интерпретатором
+    bool generate(const CompiledExpr& expr, vector<uint8_t>& code, ValueType& resultType)
+    {
+        const SymbolLayout layout = symbolLayout();
+        Emitter emit(code);
+
+        // Кадр: 32 байта shadow space и стек вычисления; после push rbx, push r12 и sub rsp
+        // указатель стека выровнен на 16 для вызовов функций библиотеки
+        int32_t frame = static_cast<int32_t>(32 + 8 * expr.maxDepth);
+        if (frame % 16 == 0)
+            frame += 8;
+
+        emit.bytes({ 0x53 });                               // push rbx
+        emit.bytes({ 0x41, 0x54 });                         // push r12
+        emit.bytes({ 0x48, 0x81, 0xEC }); emit.imm32(frame); // sub rsp, frame
+#ifdef _WIN32
+        emit.bytes({ 0x48, 0x89, 0xCB });                   // mov rbx, rcx
+        emit.bytes({ 0x49, 0x89, 0xD4 });                   // mov r12, rdx
+#else
+        emit.bytes({ 0x48, 0x89, 0xFB });                   // mov rbx, rdi
+        emit.bytes({ 0x49, 0x89, 0xF4 });                   // mov r12, rsi
+#endif
+
+        vector<ValueType> types; // Типы элементов стека вычисления
+        for (size_t i = 0; i < expr.rpn.size(); ++i) {
+            const Lexeme& lex = expr.rpn[i];
+            const TypedItem& item = expr.items[i];
+            if (item.type == ValueType::Unknown)
+                return false;
+
+            if (lex.type == LexemeType::Number) {
+                uint64_t bits;
+                if (item.literal.isInteger())
+                    bits = static_cast<uint64_t>(item.literal.intValue);
+                else
+                    memcpy(&bits, &item.literal.doubleValue, sizeof(bits));
+                emit.bytes({ 0x48, 0xB8 }); emit.imm64(bits);                   // mov rax, literal
+                emit.bytes({ 0x48, 0x89 }); emit.stackSlot(0, types.size());    // mov [top], rax
+                types.push_back(item.literal.type);
+            }
+            else if (lex.type == LexemeType::Identifier) {
+                bool integer = item.type == ValueType::Integer;
+                long long disp = static_cast<long long>(lex.slot) * static_cast<long long>(sizeof(Symbol))
+                    + (integer ? layout.intValue : layout.doubleValue);
+                if (lex.slot < 0 || disp > INT32_MAX)
+                    return false;
+                // Symbol::intValue - 32-битный int: загрузка с расширением знака
+                if (integer)
+                    emit.bytes({ 0x48, 0x63, 0x83 });                           // movsxd rax, dword [rbx + disp]
+                else
+                    emit.bytes({ 0x48, 0x8B, 0x83 });                           // mov rax, [rbx + disp]
+                emit.imm32(static_cast<int32_t>(disp));
+                emit.bytes({ 0x48, 0x89 }); emit.stackSlot(0, types.size());    // mov [top], rax
+                types.push_back(item.type);
+            }
+            else if (lex.type == LexemeType::Operator && supported(item.op) && types.size() >= 2) {
+                ValueType rhs = types.back(); types.pop_back();
+                ValueType lhs = types.back(); types.pop_back();
+                if (item.type == ValueType::Integer)
+                    emit.integerOperation(item.op, types.size());
+                else
+                    emit.realOperation(item.op, types.size(), lhs, rhs);
+                types.push_back(operatorInfo(item.op).comparison ? ValueType::Integer : item.type);
+            }
+            else {
+                return false;
+            }
+        }
+        if (types.empty())
+            return false;
+        resultType = types.back();
+
+        emit.bytes({ 0x48, 0x8B }); emit.stackSlot(0, types.size() - 1);    // mov rax, [top]
+        emit.bytes({ 0x49, 0x89, 0x04, 0x24 });                             // mov [r12], rax
+        emit.bytes({ 0x31, 0xC0 });                                         // xor eax, eax (JitOk)
+        size_t exitLabel = code.size();
+        emit.bytes({ 0x48, 0x81, 0xC4 }); emit.imm32(frame);                // add rsp, frame
+        emit.bytes({ 0x41, 0x5C });                                         // pop r12
+        emit.bytes({ 0x5B });                                               // pop rbx
+        emit.bytes({ 0xC3 });                                               // ret
+        emit.errorStubs(exitLabel);
+        return true;
+    }
+}
+
+bool JitCompiler::available()
+{
+    return true;
+}
+
+const uint8_t* JitCompiler::install(const vector<uint8_t>& code)
+{
+    if (chunks.empty() || chunks.back().size - chunks.back().used < code.size()) {
+        size_t size = (code.size() + ChunkSize - 1) / ChunkSize * ChunkSize;
+        uint8_t* data = allocatePages(size);
+        if (!data)
+            return nullptr;
+        chunks.push_back(Chunk{ data, size, 0 });
+    }
+    else if (!protectPages(chunks.back().data, chunks.back().size, false)) {
+        return nullptr;
+    }
+
+    Chunk& chunk = chunks.back();
+    uint8_t* entry = chunk.data + chunk.used;
+    memcpy(entry, code.data(), code.size());
+    if (!protectPages(chunk.data, chunk.size, true))
+        return nullptr;
+    chunk.used = min(chunk.size, (chunk.used + code.size() + 15) / 16 * 16);
+    return entry;
+}
+
+bool JitCompiler::compile(const CompiledExpr& expr)
+{
+    expr.native = nullptr;
+    if (!expr.balanced || expr.rpn.empty() || expr.maxDepth > MaxDepth)
+        return false;
+
+    vector<uint8_t> code;
+    ValueType resultType;
+    if (!generate(expr, code, resultType))
+        return false;
+    const uint8_t* entry = install(code);
+    if (!entry)
+        return false;
+
+    expr.native = reinterpret_cast<int (*)(const void*, long long*)>(const_cast<uint8_t*>(entry));
+    expr.nativeType = resultType;
+    expr.nativeOwner = id;
+    return true;
+}
+
+JitCompiler::~JitCompiler()
+{
+    for (const Chunk& chunk : chunks)
+        freePages(chunk.data, chunk.size);
+}
+
+#else // Без JIT: все выражения вычисляет интерпретатор
+
+bool JitCompiler::available()
+{
+    return false;
+}
+
+const uint8_t* JitCompiler::install(const vector<uint8_t>&)
+{
+    return nullptr;
+}
+
+bool JitCompiler::compile(const CompiledExpr& expr)
+{
+    expr.native = nullptr;
+    return false;
+}
+
+JitCompiler::~JitCompiler() = default;
+
+#endif
+
+JitCompiler::JitCompiler() : id(nextGeneration++)
+{
+}
@@ -1,51 +1,80 @@
 ﻿#include "lexer.h"
 #include <sstream>
 #include <algorithm>
+#include <array>
+#include <charconv>
+#include <stdexcept>
 
 
-map<string, LexemeType> Lexer::Database = {
-        // Ключевые слова из ТЗ и примера
-        { "program", LexemeType::Keyword },
-        { "const", LexemeType::Keyword },
-        { "var", LexemeType::Keyword },
-        { "begin", LexemeType::Keyword },
-        { "end", LexemeType::Keyword },
-        { "if", LexemeType::Keyword },
-        { "then", LexemeType::Keyword }, // Добавил then, хотя не в списке объектов, но в примере
-        { "else", LexemeType::Keyword },
-        { "read", LexemeType::Keyword },
-        { "write", LexemeType::Keyword },
-        { "div", LexemeType::Operator }, // Согласно ТЗ, div и mod - операторы
-        { "mod", LexemeType::Operator },
-
-        {"integer", LexemeType::VarType},
-        {"double", LexemeType::VarType},
-
-        // Операторы из ТЗ и примера
-        { "+", LexemeType::Operator },
-        { "-", LexemeType::Operator },
-        { "*", LexemeType::Operator },
-        { "/", LexemeType::Operator },
-        { ":=", LexemeType::Operator }, // Оператор присваивания
-        { "=", LexemeType::Operator },  // Равно
-        { "<>", LexemeType::Operator }, // Не равно
-        { "<", LexemeType::Operator },  // Меньше
-        { ">", LexemeType::Operator },  // Больше
-        { "<=", LexemeType::Operator }, // Меньше или равно
-        { ">=", LexemeType::Operator }, // Больше или равно
-
-        // Разделители из ТЗ и примера
-        { "(", LexemeType::Separator },
-        { ")", LexemeType::Separator },
-        { ";", LexemeType::Separator },
-        { ".", LexemeType::Separator }, // Точка в конце программы
-        { ",", LexemeType::Separator }, // Запятая (например, в var x, y)
-        { ":", LexemeType::Separator }, // Двоеточие (например, в var x : integer)
-        // В примере "var x, y;" нет двоеточия. В стандартном Pascal var объявление с типом `var name: type;`.
-        // Если типы в var необязательны в Pascal--, тогда двоеточие может быть не нужно. Но в ТЗ типы integer/double есть.
-        // Давайте предположим, что объявления могут быть с типом: `var x : integer;` и без: `var x, y;`.
-        // Двоеточие нужно для объявлений с типом. Добавим его как разделитель.
-};
+namespace
+{
+    // Класс символа: по нему сканер выбирает вид лексемы без поиска по словарю
+    enum class CharClass : unsigned char { Other, Space, Digit, Letter, Quote, Operator, Separator };
+
+    constexpr array<CharClass, 256> makeCharClasses()
+    {
+        array<CharClass, 256> classes{};
+        for (int c = '0'; c <= '9'; ++c) classes[c] = CharClass::Digit;
+        for (int c = 'a'; c <= 'z'; ++c) classes[c] = CharClass::Letter;
+        for (int c = 'A'; c <= 'Z'; ++c) classes[c] = CharClass::Letter;
+        classes['_'] = CharClass::Letter;
+        for (char c : { ' ', '\t', '\n', '\v', '\f', '\r' }) classes[static_cast<unsigned char>(c)] = CharClass::Space;
+        classes['"'] = CharClass::Quote;
+        // Операторы из ТЗ (двухсимвольные :=, <>, <=, >= начинаются с ':' , '<' или '>')
+        for (char c : { '+', '-', '*', '/', '=', '<', '>' }) classes[static_cast<unsigned char>(c)] = CharClass::Operator;
+        // Разделители; ':' нужен для объявлений с типом (var x : integer)
+        for (char c : { '(', ')', ';', '.', ',', ':' }) classes[static_cast<unsigned char>(c)] = CharClass::Separator;
+        return classes;
+    }
+
+    constexpr array<CharClass, 256> CharClasses = makeCharClasses();
+
+    constexpr CharClass classOf(char c)
+    {
+        return CharClasses[static_cast<unsigned char>(c)];
+    }
+
+    // Ключевые слова, типы и словесные операторы (div, mod); остальные слова - идентификаторы.
+    // Слово уже в нижнем регистре; ветвление по длине оставляет не больше трех сравнений
+    constexpr LexemeType classifyWord(string_view word)
+    {
+        switch (word.size()) {
+        case 2:
+            if (word == "if") return LexemeType::Keyword;
+            break;
+        case 3:
+            if (word == "var" || word == "end") return LexemeType::Keyword;
+            if (word == "div" || word == "mod") return LexemeType::Operator; // Согласно ТЗ, div и mod - операторы
+            break;
+        case 4:
+            if (word == "then" || word == "else" || word == "read") return LexemeType::Keyword;
+            break;
+        case 5:
+            if (word == "const" || word == "begin" || word == "write") return LexemeType::Keyword;
+            break;
+        case 6:
+            if (word == "double") return LexemeType::VarType;
+            break;
+        case 7:
+            if (word == "program") return LexemeType::Keyword;
+            if (word == "integer") return LexemeType::VarType;
+            break;
+        }
+        return LexemeType::Identifier;
+    }
+
+    static_assert(classifyWord("program") == LexemeType::Keyword, "keyword table");
+    static_assert(classifyWord("mod") == LexemeType::Operator, "keyword table");
+    static_assert(classifyWord("integer") == LexemeType::VarType, "keyword table");
+    static_assert(classifyWord("writer") == LexemeType::Identifier, "keyword table");
+
+    // Двухсимвольные операторы :=, <>, <=, >=
+    constexpr bool isTwoCharOperator(char first, char second)
+    {
+        return (first == ':' && second == '=') || (first == '<' && (second == '>' || second == '=')) ||
+            (first == '>' && second == '=');
+    }
+}
 
 std::ostream& operator<<(std::ostream& os, const Lexeme& lexeme)
 {
@@ -74,112 +103,169 @@ string lexvectostr(vector<Lexeme> v)
     return ss.str();
 }
 
+int NamePool::intern(string_view name)
+{
+    auto it = index.find(name);
+    if (it != index.end())
+        return it->second;
+
+    names.emplace_back(name);
+    int id = static_cast<int>(names.size() - 1);
+    index.emplace(names.back(), id);
+    return id;
+}
+
+Lexeme ToLexeme(const Token& token, const NamePool& pool)
+{
+    string_view text = token.name >= 0 ? pool.name(token.name) : token.text;
+    return { token.type, string(text), -1, token.number };
+}
+
+bool ParseNumberLiteral(string_view text, Value& out)
+{
+    const char* first = text.data();
+    const char* last = first + text.size();
+
+    long long whole;
+    auto [wholeEnd, wholeError] = from_chars(first, last, whole);
+    if (wholeError == errc() && wholeEnd == last) {
+        out = Value::integer(whole);
+        return true;
+    }
+    // Дробное или не помещается в 64 бита - double
+    double real;
+    auto [realEnd, realError] = from_chars(first, last, real);
+    if (realError != errc() || realEnd != last)
+        return false;
+    out = Value::real(real);
+    return true;
+}
+
+Value NumberValue(const Lexeme& lex)
+{
+    if (lex.number.type != ValueType::Unknown)
+        return lex.number;
+    Value value;
+    if (!ParseNumberLiteral(lex.value, value))
+        throw runtime_error("Invalid numeric format in the lexeme: " + lex.value);
+    return value;
+}
+
 vector<Lexeme> Lexer::Tokenize(const string& sourceCode)
 {
+    NamePool pool;
+    vector<Token> tokens = TokenizeViews(sourceCode, pool);
+
     vector<Lexeme> result;
-    size_t i = 0;
+    result.reserve(tokens.size());
+    for (const Token& token : tokens)
+        result.push_back(ToLexeme(token, pool));
+    return result;
+}
+
+vector<Token> Lexer::TokenizeViews(string_view sourceCode, NamePool& pool)
+{
+    vector<Token> result;
+    TokenStream stream(sourceCode, pool);
+    do {
+        result.push_back(stream.next());
+    } while (result.back().type != LexemeType::EndOfFile);
+    return result;
+}
+
+bool VectorLexemeSource::next(Lexeme& out)
+{
+    if (pos >= lexemes.size())
+        return false;
+    out = lexemes[pos++];
+    return true;
+}
+
+bool LexemeStream::next(Lexeme& out)
+{
+    if (finished)
+        return false;
+    Token token = tokens.next();
+    finished = token.type == LexemeType::EndOfFile;
+    out = ToLexeme(token, pool);
+    return true;
+}
+
+Token TokenStream::next()
+{
+    while (pos < source.size()) {
+        CharClass charClass = classOf(source[pos]);
 
-    while (i < sourceCode.size()) {
         // Пропуск пробелов
-        if (isspace(sourceCode[i])) {
-            ++i;
+        if (charClass == CharClass::Space) {
+            ++pos;
             continue;
         }
 
         // Строковый литерал (с базовой поддержкой)
-        if (sourceCode[i] == '"') {
-            size_t start = i; // Включаем кавычку в токен? ТЗ не специфицирует. Обычно нет.
-            ++i; // Пропускаем открывающую кавычку
-            size_t value_start = i;
-            while (i < sourceCode.size() && sourceCode[i] != '"') {
+        if (charClass == CharClass::Quote) {
+            ++pos; // Пропускаем открывающую кавычку
+            size_t value_start = pos;
+            while (pos < source.size() && source[pos] != '"') {
                 // Простая обработка экранирования, если нужно (в ТЗ нет, пропускаем)
-                // if (sourceCode[i] == '\\' && i + 1 < sourceCode.size()) i++;
-                ++i;
+                ++pos;
             }
-            if (i == sourceCode.size()) {
-                // Ошибка: незакрытая строка. Для простоты пока просто берем до конца.
-                // В реальном парсере нужно выдать ошибку.
+            // Незакрытая строка берется до конца текста
+            string_view value = source.substr(value_start, pos - value_start);
+            if (pos < source.size() && source[pos] == '"') {
+                ++pos; // Пропускаем закрывающую кавычку
             }
-            string value = sourceCode.substr(value_start, i - value_start);
-            result.push_back({ LexemeType::StringLiteral, value });
-            if (i < sourceCode.size() && sourceCode[i] == '"') {
-                ++i; // Пропускаем закрывающую кавычку
-            }
-            continue;
+            return { LexemeType::StringLiteral, value };
         }
 
-        // Число (целое или с плавающей точкой)
-        if (isdigit(sourceCode[i])) {
-            size_t start = i;
-            bool has_dot = false;
-            while (i < sourceCode.size() && (isdigit(sourceCode[i]) || sourceCode[i] == '.')) {
-                if (sourceCode[i] == '.') {
-                    if (has_dot) {
-                        // Ошибка: несколько точек в числе. Пока берем как есть.
-                        // В реальном парсере нужно выдать ошибку лексического анализа.
-                    }
-                    has_dot = true;
-                }
-                ++i;
+        // Число (целое или с плавающей точкой) разбирается сразу: вычисление берет готовое значение
+        if (charClass == CharClass::Digit) {
+            size_t start = pos;
+            size_t points = 0;
+            while (pos < source.size() && (classOf(source[pos]) == CharClass::Digit || source[pos] == '.')) {
+                points += source[pos] == '.';
+                ++pos;
             }
-            string number = sourceCode.substr(start, i - start);
-            result.push_back({ LexemeType::Number, number });
-            continue;
+            string_view text = source.substr(start, pos - start);
+            Value number;
+            if (points > 1 || !ParseNumberLiteral(text, number))
+                throw runtime_error("Malformed number '" + string(text) + "'");
+            return { LexemeType::Number, text, -1, number };
         }
 
         // Идентификатор или ключевое слово
-        if (isalpha(sourceCode[i]) || sourceCode[i] == '_') {
-            size_t start = i;
-            while (i < sourceCode.size() && (isalnum(sourceCode[i]) || sourceCode[i] == '_')) {
-                ++i;
+        if (charClass == CharClass::Letter) {
+            size_t start = pos;
+            while (pos < source.size()) {
+                CharClass nextClass = classOf(source[pos]);
+                if (nextClass != CharClass::Letter && nextClass != CharClass::Digit)
+                    break;
+                ++pos;
             }
-            string word = sourceCode.substr(start, i - start);
+            string_view word = source.substr(start, pos - start);
 
-            // Регистронезависимость: преобразуем в нижний регистр для поиска и хранения
-            string lower_word = word;
+            // Регистронезависимость: слова классифицируются и хранятся в нижнем регистре
+            lower_word.assign(word.begin(), word.end());
             transform(lower_word.begin(), lower_word.end(), lower_word.begin(), ::tolower);
 
-            auto it = Database.find(lower_word);
-            LexemeType type = (it != Database.end()) ? it->second : LexemeType::Identifier;
-
-            // Если это идентификатор, сохраняем его в нижнем регистре для единообразия
-            if (type == LexemeType::Identifier) {
-                result.push_back({ type, lower_word });
-            }
-            else {
-                // Ключевые слова/операторы div/mod сохраняем в их каноническом (нижнем) регистре
-                result.push_back({ type, lower_word });
-            }
-            continue; // Continue the outer while loop
+            return { classifyWord(lower_word), word, pool.intern(lower_word) };
         }
 
-        // Операторы и разделители (включая многосимвольные)
-        // Проверка на двухсимвольные операторы (:=, <>, <=, >=)
-        if (i + 1 < sourceCode.size()) {
-            string twoChars = sourceCode.substr(i, 2);
-            auto it = Database.find(twoChars);
-            if (it != Database.end() && it->second != LexemeType::Keyword) { // Убедимся, что это не div/mod
-                result.push_back({ it->second, twoChars });
-                i += 2;
-                continue; // Continue the outer while loop
-            }
+        // Операторы и разделители (включая двухсимвольные)
+        if (pos + 1 < source.size() && isTwoCharOperator(source[pos], source[pos + 1])) {
+            pos += 2;
+            return { LexemeType::Operator, source.substr(pos - 2, 2) };
         }
-
-        // Проверка на односимвольные операторы/разделители
-        string oneChar(1, sourceCode[i]);
-        auto it = Database.find(oneChar);
-        if (it != Database.end()) {
-            result.push_back({ it->second, oneChar });
-            ++i;
-            continue; // Continue the outer while loop
+        if (charClass == CharClass::Operator || charClass == CharClass::Separator) {
+            LexemeType type = charClass == CharClass::Operator ? LexemeType::Operator : LexemeType::Separator;
+            ++pos;
+            return { type, source.substr(pos - 1, 1) };
         }
 
         // Неизвестный символ
-        result.push_back({ LexemeType::Unknown, oneChar });
-        ++i;
+        ++pos;
+        return { LexemeType::Unknown, source.substr(pos - 1, 1) };
     }
 
-    result.push_back({ LexemeType::EndOfFile, "" });
-    return result;
-
-}
\ No newline at end of file
+    return { LexemeType::EndOfFile, source.substr(source.size()) };
+}
@@ -1,95 +1,238 @@
 #include "lexer.h"
 #include "parser.h"
 #include "program_executor.h"
+#include "bytecode.h"
+#include "optimizer.h"
 #include "hierarchical_list.h"
+#include "source_file.h"
+#include "input_source.h"
+#include "transpiler.h"
 
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
-#include <vector>
-#include <fstream>
-#include <sstream>
-#include <limits> //  std::numeric_limits
-#define NOMINMAX
-#include <windows.h>
-//      
-std::string readCodeFromFile(const std::string& filedir) {
-    std::ifstream file(filedir);
-    if (!file.is_open()) {
-        // ,    ,   
-        std::cerr << "Error: Could not open file '" << filedir << "'. Please make sure it exists." << std::endl;
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+//  Pascal--   .
+//     :    .
+
+namespace
+{
+    struct Options
+    {
+        std::string programPath;    //     "-"  stdin
+        std::string inputPath;      //     Read (  stdin)
+        std::string emitPath;       //     C++ (--emit-cpp)  "-"  stdout
+        bool dumpTokens = false;
+        bool dumpAst = false;
+        bool time = false;
+        bool fold = true;
+        bool bytecode = false;
+        std::optional<bool> prompts; // --prompt/--no-prompt;       
+        bool jit = false;
+    };
+
+    void printUsage(std::ostream& os) {
+        os << "Usage: pascal [options] <program-file | ->\n"
+            "Options:\n"
+            "  --input <file>   read values for Read from <file> instead of stdin\n"
+            "  --prompt         print 'Enter value for x:' before each Read\n"
+            "                   (default only when Read comes from a terminal)\n"
+            "  --no-prompt      never print the Read prompt\n"
+            "  --dump-tokens    print lexemes to stderr\n"
+            "  --dump-ast       print the parsed (and folded) tree to stderr\n"
+            "  --time           print time spent in each phase to stderr\n"
+            "  --no-fold        do not fold constant expressions before execution\n"
+            "  --bytecode       execute through the bytecode compiler and VM\n"
+            "  --jit            compile arithmetic expressions to x86-64 machine code\n"
+            "  --emit-cpp <out> translate the program to standalone C++ instead of running it\n"
+            "                   ('-' writes to stdout)\n"
+            "  --help           show this message\n";
+    }
+
+    //  ;     
+    std::string parseArguments(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--input") {
+                if (++i == argc) return "--input requires a file name";
+                options.inputPath = argv[i];
+            }
+            else if (arg == "--emit-cpp") {
+                if (++i == argc) return "--emit-cpp requires a file name";
+                options.emitPath = argv[i];
+            }
+            else if (arg == "--dump-tokens") options.dumpTokens = true;
+            else if (arg == "--dump-ast") options.dumpAst = true;
+            else if (arg == "--time") options.time = true;
+            else if (arg == "--no-fold") options.fold = false;
+            else if (arg == "--bytecode") options.bytecode = true;
+            else if (arg == "--prompt") options.prompts = true;
+            else if (arg == "--no-prompt") options.prompts = false;
+            else if (arg == "--jit") options.jit = true;
+            else if (arg.size() > 1 && arg[0] == '-' && arg != "-") return "unknown option '" + arg + "'";
+            else if (!options.programPath.empty()) return "more than one program file given";
+            else options.programPath = arg;
+        }
+        if (options.programPath.empty())
+            return "no program file given";
+        if (!options.emitPath.empty() && (options.bytecode || options.jit))
+            return "--emit-cpp translates the program instead of running it and cannot be combined with --bytecode or --jit";
+        if (options.jit && options.bytecode)
+            return "--jit applies to the tree interpreter and cannot be combined with --bytecode";
         return "";
     }
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
-}
 
-int main() {
-    char cwd[1024];
-    GetCurrentDirectoryA(1024, cwd);
-    std::cout << "Current working directory: " << cwd << std::endl;
-    const std::string filename = "test_prog.txt"; //    
+    // stdin   ,      
+    bool stdinIsTerminal() {
+#ifdef _WIN32
+        return _isatty(_fileno(stdin)) != 0;
+#else
+        return isatty(fileno(stdin)) != 0;
+#endif
+    }
+
+    //    stdin,   Read   ;  
+    //    Read,      
+    class ConsumedStdinSource : public InputSource
+    {
+    public:
+        bool next(double&) override {
+            throw std::runtime_error("program is read from stdin, so Read input needs --input");
+        }
+    };
+
+    //    --time;   stderr,      
+    class PhaseTimer
+    {
+        bool enabled;
+        std::chrono::steady_clock::time_point start;
 
-    std::cout << "--- Pascal-- Interpreter ---" << std::endl;
-    std::cout << "Please write your Pascal-- code in the file: '" << filename << "'" << std::endl;
-    std::cout << "You can use any text editor to modify this file." << std::endl;
-    std::cout << "Press Enter when you are done editing and want to run the code." << std::endl;
+    public:
+        explicit PhaseTimer(bool enabled) : enabled(enabled), start(std::chrono::steady_clock::now()) {}
 
-    // ,    Enter
-    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        void report(const char* phase) {
+            auto now = std::chrono::steady_clock::now();
+            if (enabled) {
+                std::cerr << std::left << std::setw(10) << phase << std::right << std::fixed << std::setprecision(3)
+                    << std::chrono::duration<double, std::milli>(now - start).count() << " ms" << std::endl;
+            }
+            start = now;
+        }
+    };
+}
 
-    std::string sourceCode = readCodeFromFile(std::string(cwd) + "\\" + filename);
+int main(int argc, char* argv[]) {
+    std::ios::sync_with_stdio(false);
 
-    if (sourceCode.empty()) {
-        std::cerr << "No code to process. Exiting." << std::endl;
-        return 1; //    ,      
+    Options options;
+    if (argc == 2 && std::string(argv[1]) == "--help") {
+        printUsage(std::cout);
+        return 0;
+    }
+    std::string usageError = parseArguments(argc, argv, options);
+    if (!usageError.empty()) {
+        std::cerr << "pascal: " << usageError << "\n";
+        printUsage(std::cerr);
+        return 2;
     }
 
-    Lexer lexer;
-    Parser parser;
-    ProgramExecutor executor;
-    HLNode* programTree = nullptr;
+    PhaseTimer timer(options.time);
+    int exitCode = 0;
 
     try {
-        std::cout << "\n--- Lexical Analysis ---\n";
-        std::vector<Lexeme> lexemes = lexer.Tokenize(sourceCode);
-        for (const auto& lex : lexemes) {
-            std::cout << lex;
+        //    ;      
+        SourceFile source(options.programPath);
+        std::string_view sourceCode = source.text();
+        timer.report(source.method() == SourceFile::LoadMethod::Mapped ? "load/mmap" : "load/read");
+
+        if (options.dumpTokens) {
+            LexemeStream dumpStream(sourceCode);
+            Lexeme lex;
+            while (dumpStream.next(lex))
+                std::cerr << lex;
+            timer.report("tokens");
         }
-        std::cout << "\n";
 
-        std::cout << "\n--- Syntax Analysis (Building AST) ---\n";
-        programTree = parser.BuildHList(lexemes);
-        if (programTree) {
-            std::cout << "AST built successfully.\n";
-            std::cout << "AST Structure:\n" << HLNodeToString(programTree, 0) << "\n";
+        //      ,    
+        HLArena nodes; //       
+        Parser parser;
+        LexemeStream lexemes(sourceCode);
+        HLNode* programTree = parser.BuildHList(lexemes, nodes);
+        timer.report("parse");
+
+        if (options.fold) {
+            ConstantFolder folder;
+            folder.Optimize(programTree);
+            timer.report("fold");
         }
-        else {
-            std::cout << "AST is empty or could not be built.\n";
+        if (options.dumpAst)
+            std::cerr << HLNodeToString(programTree, 0);
+
+        //   C++  : Read  Write   
+        if (!options.emitPath.empty()) {
+            CppTranspiler transpiler;
+            std::string code = transpiler.Translate(programTree);
+            timer.report("emit-cpp");
+            if (options.emitPath == "-") {
+                std::cout << code;
+                std::cout.flush();
+            }
+            else {
+                std::ofstream file(options.emitPath, std::ios::binary);
+                if (!(file << code) || !file.flush())
+                    throw std::runtime_error("cannot write '" + options.emitPath + "'");
+            }
+            return 0;
         }
 
-        std::cout << "\n--- Program Execution ---\n";
-        if (programTree) {
+        //   Read         iostream
+        //      ;  
+        // (  --input,   )  
+        bool stdinProgram = options.programPath == "-";
+        bool interactive = options.inputPath.empty() && !stdinProgram && stdinIsTerminal();
+        bool prompts = options.prompts.value_or(interactive);
+        StreamInputSource consoleInput(std::cin, interactive);
+        ConsumedStdinSource consumedStdin;
+        std::unique_ptr<FileInputSource> inputFile;
+        if (!options.inputPath.empty())
+            inputFile = std::make_unique<FileInputSource>(options.inputPath);
+        InputSource& input = inputFile ? static_cast<InputSource&>(*inputFile)
+            : stdinProgram ? static_cast<InputSource&>(consumedStdin) : consoleInput;
+
+        if (options.bytecode) {
+            BytecodeExecutor executor;
+            executor.setInput(input);
+            executor.setPrompts(prompts);
             executor.Execute(programTree);
-            std::cout << "\nProgram finished successfully.\n";
         }
         else {
-            std::cerr << "Cannot execute: AST is not available.\n";
+            ProgramExecutor executor;
+            executor.setInput(input);
+            executor.setPrompts(prompts);
+            executor.setJit(options.jit);
+            if (options.jit && !JitCompiler::available())
+                std::cerr << "pascal: warning: JIT is not available in this build, expressions are interpreted\n";
+            executor.Execute(programTree);
         }
-
-    }
-    catch (const ParseError& e) {
-        std::cerr << "\nParse Error: " << e.what() << std::endl;
-    }
-    catch (const std::runtime_error& e) {
-        std::cerr << "\nRuntime Error: " << e.what() << std::endl;
+        std::cout.flush();
+        timer.report("execute");
     }
     catch (const std::exception& e) {
-        std::cerr << "\nAn unexpected error occurred: " << e.what() << std::endl;
+        std::cout.flush();
+        std::cerr << "pascal: error: " << e.what() << std::endl;
+        exitCode = 1;
     }
 
-    // : ,   HLNode    hierarchical_list.h
-    delete programTree;
-
-    return 0;
-}
\ No newline at end of file
+    return exitCode;
+}
@@ -0,0 +1,225 @@
+﻿#include "optimizer.h"
+#include "declaration.h"
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+
+Lexeme ValueToLiteral(const Value& value) {
+    if (value.isInteger())
+        return { LexemeType::Number, to_string(value.intValue), -1, value };
+
+    // 17 значащих цифр восстанавливают double без потерь
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.17g", value.doubleValue);
+    string text = buffer;
+    if (text.find_first_of(".e") == string::npos)
+        text += ".0"; // Иначе литерал будет прочитан как integer
+    return { LexemeType::Number, text, -1, value };
+}
+
+size_t ConstantFolder::Optimize(HLNode* head) {
+    if (!head || head->type != NodeType::PROGRAM)
+        return 0;
+
+    HLNode* mainBlock = nullptr;
+    for (HLNode* child = head->pdown; child; child = child->pnext) {
+        if (child->type == NodeType::MAIN_BLOCK && !mainBlock)
+            mainBlock = child;
+        else if (mainBlock || (child->type != NodeType::CONST_SECTION && child->type != NodeType::VAR_SECTION))
+            return 0;
+    }
+    if (!mainBlock)
+        return 0;
+
+    // Ошибка в объявлениях: дерево еще не изменено, исполнитель сообщит о ней сам
+    try {
+        for (HLNode* child = head->pdown; child != mainBlock; child = child->pnext)
+            declare(child);
+    }
+    catch (const exception&) {
+        return 0;
+    }
+
+    rewritten = 0;
+    foldBlock(mainBlock->pdown);
+    return rewritten;
+}
+
+// Объявления обрабатываются так же, как в ProgramExecutor::handleDeclaration:
+// переменные заносятся со значением 0, константы вычисляются по порядку
+void ConstantFolder::declare(HLNode* section) {
+    for (HLNode* decl = section->pdown; decl; decl = decl->pnext) {
+        if (decl->type != NodeType::DECLARATION)
+            throw runtime_error("Unexpected node in declaration section.");
+
+        forEachDeclarationItem(decl, [&](const DeclarationItem& item) {
+            if (consts.lookup(item.name))
+                throw runtime_error("Variable '" + item.name + "' is already declared.");
+
+            if (item.isConstant) {
+                CompiledExpr compiled;
+                postfix.compile(decl->expr, item.valueFirst, item.valueLast, compiled);
+                Value result = postfix.executeTyped(compiled);
+                if (item.isInteger())
+                    consts.addInt(item.name, static_cast<int>(result.asInteger()), true);
+                else
+                    consts.addDouble(item.name, result.asDouble(), true);
+            }
+            else if (item.isInteger()) {
+                consts.addInt(item.name, 0, false);
+            }
+            else {
+                consts.addDouble(item.name, 0.0, false);
+            }
+        });
+    }
+}
+
+void ConstantFolder::foldBlock(HLNode* first) {
+    for (HLNode* node = first; node; node = node->pnext) {
+        switch (node->type) {
+        case NodeType::STATEMENT: {
+            // Сворачивается только правая часть присваивания: цель остается именем,
+            // чтобы присваивание константе по-прежнему было ошибкой
+            const vector<Lexeme>& expr = node->expr;
+            if (expr.size() > 2 && expr[0].type == LexemeType::Identifier &&
+                expr[1].type == LexemeType::Operator && expr[1].value == ":=") {
+                size_t rhsEnd = expr.size();
+                for (size_t i = 2; i < expr.size(); ++i) {
+                    if (expr[i].type == LexemeType::Separator && expr[i].value == ";") {
+                        rhsEnd = i;
+                        break;
+                    }
+                }
+                foldExpression(node, 2, rhsEnd);
+            }
+            break;
+        }
+        case NodeType::IF:
+            foldExpression(node, 0, node->expr.size());
+            foldBlock(node->pdown);
+            break;
+        case NodeType::ELSE:
+            foldBlock(node->pdown);
+            break;
+        case NodeType::CALL:
+            // Аргументы Read - имена переменных, их не трогаем
+            if (!node->expr.empty() && node->expr[0].value == "write") {
+                for (HLNode* arg = node->pdown; arg; arg = arg->pnext) {
+                    if (arg->type == NodeType::STATEMENT && !(arg->expr.size() == 1 && arg->expr[0].type == LexemeType::StringLiteral))
+                        foldExpression(arg, 0, arg->expr.size());
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void ConstantFolder::foldExpression(HLNode* node, size_t first, size_t last) {
+    vector<Lexeme>& expr = node->expr;
+    if (first >= last || last > expr.size())
+        return;
+
+    // Только числа, имена, бинарные операторы и скобки; остальное оставляем исполнителю
+    for (size_t i = first; i < last; ++i) {
+        const Lexeme& lex = expr[i];
+        bool allowed = lex.type == LexemeType::Number || lex.type == LexemeType::Identifier ||
+            (lex.type == LexemeType::Operator && PostfixExecutor::precedence(lex.value) >= 0) ||
+            (lex.type == LexemeType::Separator && (lex.value == "(" || lex.value == ")"));
+        if (!allowed)
+            return;
+    }
+
+    CompiledExpr compiled;
+    try {
+        postfix.compile(expr, first, last, compiled);
+    }
+    catch (const exception&) {
+        return;
+    }
+
+    // Восстанавливаем дерево выражения, сворачивая узлы с константными операндами
+    vector<FoldNode> nodes;
+    vector<int> stack;
+    for (size_t i = 0; i < compiled.rpn.size(); ++i) {
+        FoldNode fold;
+        fold.lex = compiled.rpn[i];
+        fold.lex.slot = -1;
+
+        if (fold.lex.type == LexemeType::Number) {
+            fold.constant = true;
+            fold.value = compiled.items[i].literal;
+        }
+        else if (fold.lex.type == LexemeType::Identifier) {
+            const Symbol* symbol = consts.lookup(fold.lex.value);
+            if (symbol && symbol->isConstant) {
+                fold.constant = fold.folded = true;
+                fold.value = symbol->isInteger ? Value::integer(symbol->intValue) : Value::real(symbol->doubleValue);
+            }
+        }
+        else if (fold.lex.type == LexemeType::Operator && stack.size() >= 2) {
+            fold.right = stack.back(); stack.pop_back();
+            fold.left = stack.back(); stack.pop_back();
+            if (nodes[fold.left].constant && nodes[fold.right].constant) {
+                try {
+                    Value value = postfix.applyOperator(fold.lex.value, nodes[fold.left].value, nodes[fold.right].value);
+                    if (value.isInteger() || std::isfinite(value.doubleValue)) {
+                        fold.constant = fold.folded = true;
+                        fold.value = value;
+                    }
+                }
+                catch (const runtime_error&) {
+                    // Ошибку вычисления оставляем до выполнения
+                }
+            }
+        }
+        else {
+            return; // Некорректная постфиксная запись
+        }
+
+        nodes.push_back(fold);
+        stack.push_back(static_cast<int>(nodes.size() - 1));
+    }
+    if (stack.size() != 1)
+        return;
+
+    vector<Lexeme> folded;
+    emit(nodes, stack.back(), -1, false, folded);
+
+    vector<Lexeme> original(expr.begin() + first, expr.begin() + last);
+    if (folded == original)
+        return;
+
+    expr.erase(expr.begin() + first, expr.begin() + last);
+    expr.insert(expr.begin() + first, folded.begin(), folded.end());
+    // Кэш постфиксной записи построен по старому выражению
+    delete node->compiled;
+    node->compiled = nullptr;
+    ++rewritten;
+}
+
+// Запись дерева обратно в инфиксную форму со скобками только там, где они нужны
+// (все операторы левоассоциативны)
+void ConstantFolder::emit(const vector<FoldNode>& nodes, int index, int parentPrecedence, bool isRight, vector<Lexeme>& out) const {
+    const FoldNode& node = nodes[index];
+    if (node.folded) {
+        out.push_back(ValueToLiteral(node.value));
+        return;
+    }
+    if (node.left < 0) {
+        out.push_back(node.lex);
+        return;
+    }
+
+    int precedence = PostfixExecutor::precedence(node.lex.value);
+    bool parens = precedence < parentPrecedence || (isRight && precedence == parentPrecedence);
+    if (parens)
+        out.push_back({ LexemeType::Separator, "(" });
+    emit(nodes, node.left, precedence, false, out);
+    out.push_back(node.lex);
+    emit(nodes, node.right, precedence, true, out);
+    if (parens)
+        out.push_back({ LexemeType::Separator, ")" });
+}
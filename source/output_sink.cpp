@@ -0,0 +1,41 @@
+﻿#include "output_sink.h"
+
+#include <charconv>
+#include <cmath>
+
+char* FormatNumber(double value, char* first, char* last)
+{
+    // Целые значения, которые %g выводит без экспоненты, печатаются как целые числа:
+    // это самый частый случай и самый дешевый путь. -0 выводится потоком как "-0"
+    if (value > -1e6 && value < 1e6) {
+        long long whole = static_cast<long long>(value);
+        if (static_cast<double>(whole) == value && !(whole == 0 && signbit(value)))
+            return to_chars(first, last, whole).ptr;
+    }
+    return to_chars(first, last, value, chars_format::general, 6).ptr;
+}
+
+OutputSink::OutputSink(ostream& out, size_t capacity) : out(&out), capacity(capacity ? capacity : 1)
+{
+    buffer.reserve(this->capacity);
+}
+
+OutputSink::~OutputSink()
+{
+    flush();
+}
+
+void OutputSink::writeNumber(double value)
+{
+    char text[32];
+    write(string_view(text, FormatNumber(value, text, text + sizeof(text)) - text));
+}
+
+void OutputSink::flush()
+{
+    if (!buffer.empty()) {
+        out->write(buffer.data(), static_cast<streamsize>(buffer.size()));
+        buffer.clear();
+    }
+    out->flush();
+}
@@ -1,23 +1,83 @@
-﻿#include "Parser.h"
+﻿#include "parser.h"
 
-Lexeme& Parser::currentLex() { return lexemes[pos]; }
+Lexeme& Parser::currentLex() { return current; }
 
-bool Parser::match(LexemeType type) { return pos < lexemes.size() && currentLex().type == type; }
+bool Parser::match(LexemeType type) { return !atEnd() && currentLex().type == type; }
 
 bool Parser::matchKeyword(const string& kw) {
-    return pos < lexemes.size() && currentLex().type == LexemeType::Keyword && currentLex().value == kw;
+    return !atEnd() && currentLex().type == LexemeType::Keyword && currentLex().value == kw;
 }
 
-void Parser::advance() { if (pos < lexemes.size()) pos++; }
+void Parser::advance() { if (!atEnd()) hasCurrent = input->next(current); }
+
+namespace
+{
+    // Построение HLNode: узлы в регионе или через new, добавление через HLNodeAppender
+    class HLNodeSink : public ParseTreeSink
+    {
+        HLArena* arena;
+        vector<HLNode*> nodes;
+        vector<HLNodeAppender> children;
+
+    public:
+        explicit HLNodeSink(HLArena* arena) : arena(arena) {}
+
+        int create(NodeType type, vector<Lexeme> expr) override {
+            HLNode* node = arena ? arena->create(type, move(expr)) : new HLNode(type, move(expr));
+            nodes.push_back(node);
+            children.emplace_back(node);
+            return static_cast<int>(nodes.size() - 1);
+        }
+
+        void append(int parent, int child) override {
+            children[parent].append(nodes[child]);
+        }
+
+        HLNode* root() const { return nodes.empty() ? nullptr : nodes[0]; }
+
+        // Освобождение после ошибки разбора (часть узлов может быть еще не привязана к дереву)
+        void discard() {
+            if (arena) return; // Узлы освободит регион
+            for (HLNode* node : nodes) {
+                node->pdown = node->pnext = nullptr;
+                delete node;
+            }
+            nodes.clear();
+        }
+    };
+
+    // Построение FlatAST: последний ребенок каждого узла запоминается для добавления за O(1)
+    class FlatASTSink : public ParseTreeSink
+    {
+        FlatAST& ast;
+        vector<int> lastChild;
+
+    public:
+        explicit FlatASTSink(FlatAST& ast) : ast(ast) {}
+
+        int create(NodeType type, vector<Lexeme> expr) override {
+            lastChild.push_back(FlatAST::None);
+            return ast.addNode(type, move(expr));
+        }
 
-HLNode* Parser::createNode(NodeType type, const vector<Lexeme>& expr) {
-    return new HLNode{ type, expr };
+        void append(int parent, int child) override {
+            if (lastChild[parent] == FlatAST::None)
+                ast.firstChild[parent] = child;
+            else
+                ast.nextSibling[lastChild[parent]] = child;
+            lastChild[parent] = child;
+        }
+    };
+}
+
+int Parser::createNode(NodeType type, vector<Lexeme> expr) {
+    return sink->create(type, move(expr));
 }
 
 vector<Lexeme> Parser::collectUntil(const function<bool()>& predicate) {
     vector<Lexeme> res;
-    while (pos < lexemes.size() && !predicate()) {
-        res.push_back(currentLex());
+    while (!atEnd() && !predicate()) {
+        res.push_back(move(currentLex()));
         advance();
     }
     return res;
@@ -33,60 +93,37 @@ vector<Lexeme> Parser::parseDeclaration() {
 }
 
 // Парсит секцию const или var
-void Parser::parseSection(HLNode* parent, NodeType sectionType) {
+void Parser::parseSection(int parent, NodeType sectionType) {
     advance(); // Пропускаем "const" или "var"
     auto sectionNode = createNode(sectionType);
 
     // Добавляем секцию как дочерний узел к родителю
-    if (!parent->pdown) parent->pdown = sectionNode;
-    else {
-        auto last = parent->pdown;
-        while (last->pnext) last = last->pnext;
-        last->pnext = sectionNode;
-    }
+    sink->append(parent, sectionNode);
 
     // Парсим все объявления в секции
-    while (pos < lexemes.size() && !matchKeyword("var") && !matchKeyword("begin")) {
+    while (!atEnd() && !matchKeyword("var") && !matchKeyword("begin")) {
         auto decl = parseDeclaration();
         if (!decl.empty()) {
-            auto declNode = createNode(NodeType::DECLARATION, decl);
-            if (!sectionNode->pdown) sectionNode->pdown = declNode;
-            else {
-                auto lastDecl = sectionNode->pdown;
-                while (lastDecl->pnext) lastDecl = lastDecl->pnext;
-                lastDecl->pnext = declNode;
-            }
+            sink->append(sectionNode, createNode(NodeType::DECLARATION, move(decl)));
         }
     }
 }
 
-void Parser::parseStatement(HLNode* parent) {
+void Parser::parseStatement(int parent) {
     if (match(LexemeType::Keyword) && (currentLex().value == "write" || currentLex().value == "read")) {
-        auto callNode = parseFunctionCall();
-        if (!parent->pdown) parent->pdown = callNode;
-        else {
-            auto last = parent->pdown;
-            while (last->pnext) last = last->pnext;
-            last->pnext = callNode;
-        }
+        sink->append(parent, parseFunctionCall());
     }
     else { //оператор обычный
         auto stmt = collectUntil([&]() { return match(LexemeType::Separator) && currentLex().value == ";"; });
         advance(); // Пропускаем точку с запятой
 
         if (!stmt.empty()) {
-            auto node = createNode(NodeType::STATEMENT, stmt);
-            if (!parent->pdown) parent->pdown = node;
-            else {
-                auto last = parent->pdown;
-                while (last->pnext) last = last->pnext;
-                last->pnext = node;
-            }
+            sink->append(parent, createNode(NodeType::STATEMENT, move(stmt)));
         }
     }
 }
 
-HLNode* Parser::parseFunctionCall() {
+int Parser::parseFunctionCall() {
     auto funcName = currentLex();
     advance(); // Пропускаем имя функции
     if (!match(LexemeType::Separator) || currentLex().value != "(") {
@@ -96,25 +133,19 @@ HLNode* Parser::parseFunctionCall() {
     advance(); // Пропускаем открывающую скобку
 
     // Собираем аргументы пока не встретим закрывающую скобку
-    while (!match(LexemeType::Separator) || currentLex().value != ")") {
+    while (!atEnd() && (!match(LexemeType::Separator) || currentLex().value != ")")) {
         auto arg = collectUntil([&]() {
             return match(LexemeType::Separator) && (currentLex().value == "," || currentLex().value == ")");
             });
 
         // Создаем узел аргумента
         if (!arg.empty()) {
-            auto argNode = createNode(NodeType::STATEMENT, arg);
-            if (!callNode->pdown) callNode->pdown = argNode;
-            else {
-                auto lastArg = callNode->pdown;
-                while (lastArg->pnext) lastArg = lastArg->pnext;
-                lastArg->pnext = argNode;
-            }
+            sink->append(callNode, createNode(NodeType::STATEMENT, move(arg)));
         }
 
         if (match(LexemeType::Separator) && currentLex().value == ",") advance();
     }
-    if (pos >= lexemes.size() || !match(LexemeType::Separator) || currentLex().value != ")") {
+    if (atEnd() || !match(LexemeType::Separator) || currentLex().value != ")") {
         throw runtime_error("Expected ')' after function arguments");
     }
     advance(); // Пропускаем закрывающую скобку
@@ -122,17 +153,18 @@ HLNode* Parser::parseFunctionCall() {
     return callNode;
 }
 
-HLNode* Parser::parseIf() {
+void Parser::parseIf(int parent) {
     advance(); // Пропускаем 'if'
     if (matchKeyword("then") || matchKeyword("begin")) {
         throw runtime_error("Missing condition after 'if'");
     }
-    auto ifNode = createNode(NodeType::IF);
 
     // Собираем условие до then/begin
-    ifNode->expr = collectUntil([&]() {
+    auto condition = collectUntil([&]() {
         return matchKeyword("then") || matchKeyword("begin");
         });
+    auto ifNode = createNode(NodeType::IF, move(condition));
+    sink->append(parent, ifNode);
 
     // Пропускаем then если есть
     if (matchKeyword("then")) advance();
@@ -146,19 +178,17 @@ HLNode* Parser::parseIf() {
         parseStatement(ifNode);
     }
 
-    // Обработка else
+    // Обработка else: узел ELSE следует за IF на том же уровне
     if (matchKeyword("else")) {
         advance();
         auto elseNode = createNode(NodeType::ELSE);
-        ifNode->pnext = elseNode;
+        sink->append(parent, elseNode);
         parseStatement(elseNode);
     }
-
-    return ifNode;
 }
 
-void Parser::parseBlock(HLNode* parent) {
-    while (pos < lexemes.size()) {
+void Parser::parseBlock(int parent) {
+    while (!atEnd()) {
         if (matchKeyword("end")) {
             advance();
             if (match(LexemeType::Separator) && currentLex().value == ";") advance();
@@ -166,27 +196,66 @@ void Parser::parseBlock(HLNode* parent) {
         }
 
         if (matchKeyword("if")) {
-            auto node = parseIf();
-            if (!parent->pdown) parent->pdown = node;
-            else {
-                auto last = parent->pdown;
-                while (last->pnext) last = last->pnext;
-                last->pnext = node;
-            }
+            parseIf(parent);
         }
         else {
             parseStatement(parent);
         }
     }
-    if (pos >= lexemes.size()) {
+    if (atEnd()) {
         throw runtime_error("Unclosed block (missing 'end')");
     }
 }
 
 HLNode* Parser::BuildHList(vector<Lexeme>& input) {
-    lexemes = input;
-    root = createNode(NodeType::PROGRAM);
-    current = root;
+    VectorLexemeSource source(input);
+    return BuildHList(source);
+}
+
+HLNode* Parser::BuildHList(vector<Lexeme>& input, HLArena& nodes) {
+    VectorLexemeSource source(input);
+    return BuildHList(source, nodes);
+}
+
+FlatAST Parser::BuildFlat(vector<Lexeme>& input) {
+    VectorLexemeSource source(input);
+    FlatAST ast;
+    ast.tokens.reserve(input.size()); // Лексемы выражений - подмножество входных
+    FlatASTSink target(ast);
+    parseProgram(source, target);
+    return ast;
+}
+
+HLNode* Parser::BuildHList(LexemeSource& source) {
+    HLNodeSink target(nullptr);
+    try {
+        parseProgram(source, target);
+    }
+    catch (...) {
+        target.discard();
+        throw;
+    }
+    return target.root();
+}
+
+HLNode* Parser::BuildHList(LexemeSource& source, HLArena& nodes) {
+    HLNodeSink target(&nodes); // Частично построенные при ошибке узлы освободит регион
+    parseProgram(source, target);
+    return target.root();
+}
+
+FlatAST Parser::BuildFlat(LexemeSource& source) {
+    FlatAST ast;
+    FlatASTSink target(ast);
+    parseProgram(source, target);
+    return ast;
+}
+
+void Parser::parseProgram(LexemeSource& source, ParseTreeSink& target) {
+    input = &source;
+    hasCurrent = input->next(current);
+    sink = &target;
+    int root = createNode(NodeType::PROGRAM);
 
     // Пропускаем заголовок программы (program name;)
     if (matchKeyword("program")) {
@@ -194,14 +263,14 @@ HLNode* Parser::BuildHList(vector<Lexeme>& input) {
         if (!match(LexemeType::Identifier)) {
             throw runtime_error("Expected program name after 'program'");
         }
-        while (pos < lexemes.size() && !(match(LexemeType::Separator) && currentLex().value == ";")) {
+        while (!atEnd() && !(match(LexemeType::Separator) && currentLex().value == ";")) {
             advance();
         }
         advance(); // Пропускаем точку с запятой
     }
 
     // Парсим секции const и var
-    while (pos < lexemes.size()) {
+    while (!atEnd()) {
         if (matchKeyword("const")) {
             parseSection(root, NodeType::CONST_SECTION);
         }
@@ -211,12 +280,7 @@ HLNode* Parser::BuildHList(vector<Lexeme>& input) {
         else if (matchKeyword("begin")) {
             advance();
             auto mainBlock = createNode(NodeType::MAIN_BLOCK);
-            if (!root->pdown) root->pdown = mainBlock;
-            else {
-                auto last = root->pdown;
-                while (last->pnext) last = last->pnext;
-                last->pnext = mainBlock;
-            }
+            sink->append(root, mainBlock);
             parseBlock(mainBlock);
             break;
         }
@@ -224,26 +288,28 @@ HLNode* Parser::BuildHList(vector<Lexeme>& input) {
             advance(); // Пропускаем неизвестные лексемы перед begin
         }
     }
-
-    return root;
 }
 
-// Для преобразования структуры в строку
+// Для преобразования структуры в строку (обход без рекурсии: длина цепочек не ограничена стеком)
 std::string HLNodeToString(const HLNode* node, int level = 0) {
-    std::string indent(level * 2, ' ');
     std::stringstream ss;
+    vector<pair<const HLNode*, int>> stack; // Узел и его уровень вложенности
+    if (node) stack.push_back({ node, level });
 
-    if (!node) return "";
+    while (!stack.empty()) {
+        auto [current, depth] = stack.back();
+        stack.pop_back();
 
-    ss << indent << "[" << NodeTypeToString(node->type);
-    if (!node->expr.empty()) {
-        ss << ": ";
-        for (const auto& lex : node->expr) ss << lex.value << " ";
-    }
-    ss << "]\n";
+        ss << std::string(depth * 2, ' ') << "[" << NodeTypeToString(current->type);
+        if (!current->expr.empty()) {
+            ss << ": ";
+            for (const auto& lex : current->expr) ss << lex.value << " ";
+        }
+        ss << "]\n";
 
-    if (node->pdown) ss << HLNodeToString(node->pdown, level + 1);
-    if (node->pnext) ss << HLNodeToString(node->pnext, level);
+        if (current->pnext) stack.push_back({ current->pnext, depth });
+        if (current->pdown) stack.push_back({ current->pdown, depth + 1 });
+    }
 
     return ss.str();
 }
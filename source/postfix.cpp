@@ -1,23 +1,80 @@
 ﻿#include "postfix.h"
 #include <stack>
+#include <algorithm>
+#include <cstring>
 #include <cmath>
 #include <stdexcept>
 #include <iostream>
-#include <map>
 
 using namespace std;
 
-// Приоритеты операторов
-const map<string, int> OPERATOR_PRECEDENCE = {
-    {"or", 1}, {"and", 2},
-    {"=", 3}, {"<>", 3}, {"<", 3}, {">", 3}, {"<=", 3}, {">=", 3},
-    {"+", 4}, {"-", 4},
-    {"*", 5}, {"/", 5}, {"div", 5}, {"mod", 5},
-    {"not", 6}
-};
+namespace
+{
+    // Обработчик операции над значениями; выбирается по виду оператора из таблицы
+    using OperationHandler = Value (*)(const Value& lhs, const Value& rhs);
+    using HandlerTable = array<OperationHandler, static_cast<size_t>(OperatorKind::Count)>;
+
+    // Целочисленные операции (оба операнда integer). Сложение, вычитание и умножение выполняются
+    // с переполнением по модулю 2^64 (без неопределенного поведения), div и mod дают те же результаты,
+    // что и вещественный путь: div округляет частное вниз, знак mod совпадает со знаком делимого.
+    constexpr HandlerTable makeIntHandlers() {
+        typedef unsigned long long ull;
+        HandlerTable table{};
+        table[size_t(OperatorKind::Add)] = [](const Value& a, const Value& b) {
+            return Value::integer(static_cast<long long>(static_cast<ull>(a.intValue) + static_cast<ull>(b.intValue))); };
+        table[size_t(OperatorKind::Sub)] = [](const Value& a, const Value& b) {
+            return Value::integer(static_cast<long long>(static_cast<ull>(a.intValue) - static_cast<ull>(b.intValue))); };
+        table[size_t(OperatorKind::Mul)] = [](const Value& a, const Value& b) {
+            return Value::integer(static_cast<long long>(static_cast<ull>(a.intValue) * static_cast<ull>(b.intValue))); };
+        table[size_t(OperatorKind::IntDiv)] = [](const Value& a, const Value& b) { return Value::integer(IntDivide(a.intValue, b.intValue)); };
+        table[size_t(OperatorKind::Mod)] = [](const Value& a, const Value& b) { return Value::integer(IntModulo(a.intValue, b.intValue)); };
+        table[size_t(OperatorKind::Eq)] = [](const Value& a, const Value& b) { return Value::integer(a.intValue == b.intValue); };
+        table[size_t(OperatorKind::Ne)] = [](const Value& a, const Value& b) { return Value::integer(a.intValue != b.intValue); };
+        table[size_t(OperatorKind::Lt)] = [](const Value& a, const Value& b) { return Value::integer(a.intValue < b.intValue); };
+        table[size_t(OperatorKind::Gt)] = [](const Value& a, const Value& b) { return Value::integer(a.intValue > b.intValue); };
+        table[size_t(OperatorKind::Le)] = [](const Value& a, const Value& b) { return Value::integer(a.intValue <= b.intValue); };
+        table[size_t(OperatorKind::Ge)] = [](const Value& a, const Value& b) { return Value::integer(a.intValue >= b.intValue); };
+        return table;
+    }
+
+    // Вещественные операции (хотя бы один операнд double, а также "/")
+    constexpr HandlerTable makeRealHandlers() {
+        HandlerTable table{};
+        table[size_t(OperatorKind::Add)] = [](const Value& a, const Value& b) { return Value::real(a.asDouble() + b.asDouble()); };
+        table[size_t(OperatorKind::Sub)] = [](const Value& a, const Value& b) { return Value::real(a.asDouble() - b.asDouble()); };
+        table[size_t(OperatorKind::Mul)] = [](const Value& a, const Value& b) { return Value::real(a.asDouble() * b.asDouble()); };
+        table[size_t(OperatorKind::Div)] = [](const Value& a, const Value& b) {
+            if (b.asDouble() == 0) throw runtime_error(DivisionByZeroMessage);
+            return Value::real(a.asDouble() / b.asDouble()); };
+        table[size_t(OperatorKind::IntDiv)] = [](const Value& a, const Value& b) {
+            if (b.asDouble() == 0) throw runtime_error(IntDivisionByZeroMessage);
+            return Value::real(floor(a.asDouble() / b.asDouble())); };
+        table[size_t(OperatorKind::Mod)] = [](const Value& a, const Value& b) {
+            if (b.asDouble() == 0) throw runtime_error(ModByZeroMessage);
+            return Value::real(fmod(a.asDouble(), b.asDouble())); };
+        table[size_t(OperatorKind::Eq)] = [](const Value& a, const Value& b) { return Value::integer(a.asDouble() == b.asDouble()); };
+        table[size_t(OperatorKind::Ne)] = [](const Value& a, const Value& b) { return Value::integer(a.asDouble() != b.asDouble()); };
+        table[size_t(OperatorKind::Lt)] = [](const Value& a, const Value& b) { return Value::integer(a.asDouble() < b.asDouble()); };
+        table[size_t(OperatorKind::Gt)] = [](const Value& a, const Value& b) { return Value::integer(a.asDouble() > b.asDouble()); };
+        table[size_t(OperatorKind::Le)] = [](const Value& a, const Value& b) { return Value::integer(a.asDouble() <= b.asDouble()); };
+        table[size_t(OperatorKind::Ge)] = [](const Value& a, const Value& b) { return Value::integer(a.asDouble() >= b.asDouble()); };
+        return table;
+    }
+
+    constexpr HandlerTable IntHandlers = makeIntHandlers();
+    constexpr HandlerTable RealHandlers = makeRealHandlers();
+}
 
 PostfixExecutor::PostfixExecutor(TableManager* varTablep) : vartable(varTablep) {}
 
+void PostfixExecutor::setJit(bool enabled, uint32_t threshold) {
+    jitThreshold = threshold;
+    if (!enabled)
+        jit.reset();
+    else if (!jit && JitCompiler::available())
+        jit = make_unique<JitCompiler>();
+}
+
 void PostfixExecutor::buildPostfix(HLNode* node) {
     if (!node) return;
 
@@ -31,39 +88,8 @@ void PostfixExecutor::buildPostfix(HLNode* node) {
 
     case NodeType::STATEMENT:
         // Обрабатываем выражения
-        if (!node->expr.empty()) {
-            stack<Lexeme> operators;
-
-            for (const auto& lex : node->expr) {
-                if (lex.type == LexemeType::Number || lex.type == LexemeType::Identifier) {
-                    postfix.push_back(lex);
-                }
-                else if (lex.value == "(") {
-                    operators.push(lex);
-                }
-                else if (lex.value == ")") {
-                    while (!operators.empty() && operators.top().value != "(") {
-                        postfix.push_back(operators.top());
-                        operators.pop();
-                    }
-                    if (!operators.empty()) operators.pop();
-                }
-                else if (lex.type == LexemeType::Operator) {
-                    while (!operators.empty() &&
-                        operators.top().value != "(" &&
-                        OPERATOR_PRECEDENCE.at(operators.top().value) >= OPERATOR_PRECEDENCE.at(lex.value)) {
-                        postfix.push_back(operators.top());
-                        operators.pop();
-                    }
-                    operators.push(lex);
-                }
-            }
-
-            while (!operators.empty()) {
-                postfix.push_back(operators.top());
-                operators.pop();
-            }
-        }
+        if (!node->expr.empty())
+            appendPostfix(node->expr.data(), node->expr.data() + node->expr.size(), postfix);
         break;
     }
 
@@ -72,121 +98,286 @@ void PostfixExecutor::buildPostfix(HLNode* node) {
         buildPostfix(node->pnext);
 }
 
+// Алгоритм сортировочной станции для диапазона лексем [first, last)
+void PostfixExecutor::appendPostfix(const Lexeme* first, const Lexeme* last, vector<Lexeme>& out) {
+    stack<const Lexeme*> operators;
+
+    for (const Lexeme* it = first; it != last; ++it) {
+        const Lexeme& lex = *it;
+        if (lex.type == LexemeType::Number || lex.type == LexemeType::Identifier) {
+            out.push_back(lex);
+        }
+        else if (lex.value == "(") {
+            operators.push(&lex);
+        }
+        else if (lex.value == ")") {
+            while (!operators.empty() && operators.top()->value != "(") {
+                out.push_back(*operators.top());
+                operators.pop();
+            }
+            if (!operators.empty()) operators.pop();
+        }
+        else if (lex.type == LexemeType::Operator) {
+            const OperatorInfo& info = operatorInfo(ClassifyOperator(lex.value));
+            if (info.precedence < 0)
+                throw runtime_error("Неизвестный оператор: " + lex.value);
+            while (!operators.empty() && operators.top()->value != "(") {
+                int top = operatorInfo(ClassifyOperator(operators.top()->value)).precedence;
+                if (top < info.precedence || (top == info.precedence && info.rightAssociative))
+                    break;
+                out.push_back(*operators.top());
+                operators.pop();
+            }
+            operators.push(&lex);
+        }
+    }
+
+    while (!operators.empty()) {
+        out.push_back(*operators.top());
+        operators.pop();
+    }
+}
+
 void PostfixExecutor::toPostfix(HLNode* start) {
     postfix.clear();
     buildPostfix(start);
 }
 
 double PostfixExecutor::executePostfix() {
-    stack<double> stk;
+    // Типы выводятся при каждом вызове: между toPostfix и executePostfix таблица может измениться
+    legacy.rpn = postfix;
+    inferTypes(legacy);
+    return evaluate(legacy).asDouble();
+}
+
+void PostfixExecutor::compile(const vector<Lexeme>& expr, size_t first, size_t last, CompiledExpr& out) {
+    out.rpn.clear();
+    if (last > expr.size()) last = expr.size();
+    if (first < last)
+        appendPostfix(expr.data() + first, expr.data() + last, out.rpn);
+    inferTypes(out);
+    if (jit && jitThreshold == 0)
+        jit->compile(out);
+}
+
+double PostfixExecutor::execute(const CompiledExpr& compiled) {
+    return evaluate(compiled).asDouble();
+}
+
+Value PostfixExecutor::executeTyped(const CompiledExpr& compiled) {
+    return evaluate(compiled);
+}
+
+// Однократный вывод типов: литералы разбираются, идентификаторам проставляются слоты,
+// для каждого оператора определяется, выполняется он над integer или над double.
+// Попутно находится наибольшая глубина стека и проверяется, что операндов хватает всем операторам
+void PostfixExecutor::inferTypes(CompiledExpr& compiled) {
+    compiled.items.assign(compiled.rpn.size(), TypedItem{ ValueType::Unknown, Value() });
+    compiled.maxDepth = 0;
+    compiled.balanced = true;
+    compiled.native = nullptr; // Машинный код прежней записи недействителен
+    compiled.evaluations = 0;
+    vector<ValueType> types; // Типы значений на стеке при вычислении
+
+    for (size_t i = 0; i < compiled.rpn.size(); ++i) {
+        Lexeme& lex = compiled.rpn[i];
+        TypedItem& item = compiled.items[i];
 
-    for (const Lexeme& lex : postfix) {
         if (lex.type == LexemeType::Number) {
-            stk.push(stod(lex.value));
+            // Значение литерала разобрано лексером (целое, если помещается в 64 бита, иначе double)
+            item.literal = NumberValue(lex);
+            item.type = item.literal.type;
+            types.push_back(item.type);
         }
         else if (lex.type == LexemeType::Identifier) {
-            stk.push(getValueFromLexeme(lex));
+            if (lex.slot < 0)
+                lex.slot = vartable->findSlot(lex.value);
+            // Необъявленное имя остается Unknown: ошибка возникнет при вычислении
+            if (lex.slot >= 0)
+                item.type = vartable->symbol(lex.slot).isInteger ? ValueType::Integer : ValueType::Double;
+            types.push_back(item.type);
         }
-        else if (lex.type == LexemeType::Operator) {
-            if (lex.value == ":=") {
-                throw runtime_error("Assignment operator (:=) should be handled by ProgramExecutor, not PostfixExecutor directly.");
-            }
-            else if (isComparisonOperator(lex.value)) {
-                if (stk.size() < 2) throw runtime_error("Not enough operands for comparison.");
+        else if (lex.type == LexemeType::Operator && (item.op = ClassifyOperator(lex.value)) != OperatorKind::Assign && types.size() >= 2) {
+            ValueType rhs = types.back(); types.pop_back();
+            ValueType lhs = types.back(); types.pop_back();
+            item.type = operationType(item.op, lhs, rhs);
+            bool comparison = operatorInfo(item.op).comparison;
+            types.push_back(comparison && item.type != ValueType::Unknown ? ValueType::Integer : item.type);
+        }
+        else {
+            // Некорректная запись: ошибка будет выдана при вычислении, дальше типы неизвестны
+            types.assign(types.size() + 1, ValueType::Unknown);
+            compiled.balanced = false;
+        }
+        compiled.maxDepth = max(compiled.maxDepth, types.size());
+    }
+}
 
-                double rhs = stk.top(); stk.pop();
-                double lhs = stk.top(); stk.pop();
+ValueType PostfixExecutor::operationType(OperatorKind op, ValueType lhs, ValueType rhs) {
+    if (lhs == ValueType::Unknown || rhs == ValueType::Unknown)
+        return ValueType::Unknown;
+    if (op == OperatorKind::Div)
+        return ValueType::Double; // Деление всегда вещественное
+    return lhs == ValueType::Integer && rhs == ValueType::Integer ? ValueType::Integer : ValueType::Double;
+}
 
-                stk.push(evaluateCondition(lex.value, lhs, rhs) ? 1.0 : 0.0);
-            }
-            else {
-                if (stk.size() < 2) throw runtime_error("Not enough operands for operation: " + lex.value);
+// Сбалансированное выражение вычисляется на непрерывном стеке глубины maxDepth: нехватка операндов
+// исключена при компиляции, поэтому проверок на каждом операторе нет, а стек не выделяется заново
+Value PostfixExecutor::evaluate(const CompiledExpr& compiled) {
+    if (jit) {
+        if (compiled.native && compiled.nativeOwner == jit->generation())
+            return evaluateNative(compiled);
+        if (++compiled.evaluations == jitThreshold && jit->compile(compiled))
+            return evaluateNative(compiled);
+    }
+    if (!compiled.balanced)
+        return evaluateChecked(compiled);
+    if (evalStack.size() < compiled.maxDepth)
+        evalStack.resize(compiled.maxDepth);
 
-                double rhs = stk.top(); stk.pop();
-                double lhs = stk.top(); stk.pop();
-                stk.push(evaluateOperation(lex.value, lhs, rhs));
-            }
+    const vector<Lexeme>& rpn = compiled.rpn;
+    Value* const base = evalStack.data();
+    Value* sp = base;
+
+    for (size_t i = 0; i < rpn.size(); ++i) {
+        const Lexeme& lex = rpn[i];
+        const TypedItem& item = compiled.items[i];
+
+        if (lex.type == LexemeType::Number) {
+            *sp++ = item.literal;
+        }
+        else if (lex.type == LexemeType::Identifier) {
+            if (item.type == ValueType::Integer)
+                *sp++ = Value::integer(vartable->symbol(lex.slot).intValue);
+            else if (item.type == ValueType::Double)
+                *sp++ = Value::real(vartable->symbol(lex.slot).doubleValue);
+            else
+                *sp++ = getValueFromLexeme(lex);
         }
         else {
-            throw runtime_error("Unexpected lexeme type in postfix expression: " + lex.value);
+            // Остальное в сбалансированной записи - бинарный оператор
+            Value rhs = *--sp;
+            ValueType type = item.type;
+            if (type == ValueType::Unknown)
+                type = operationType(item.op, sp[-1].type, rhs.type);
+            sp[-1] = applyOperation(item.op, type, sp[-1], rhs);
         }
     }
 
-    if (stk.empty()) {
-        return 0.0;
+    return sp == base ? Value::real(0.0) : sp[-1];
+}
+
+// Машинный код получает текущее начало таблицы символов (вектор мог переместиться после компиляции)
+// и возвращает код ошибки; сообщения те же, что у интерпретатора
+Value PostfixExecutor::evaluateNative(const CompiledExpr& compiled) {
+    const void* symbols = vartable->slotCount() ? &vartable->symbol(0) : nullptr;
+    long long bits;
+    switch (compiled.native(symbols, &bits)) {
+    case JitOk:
+        break;
+    case JitDivisionByZero:
+        throw runtime_error(DivisionByZeroMessage);
+    case JitIntDivisionByZero:
+        throw runtime_error(IntDivisionByZeroMessage);
+    default:
+        throw runtime_error(ModByZeroMessage);
     }
-    return stk.top();
+    if (compiled.nativeType == ValueType::Integer)
+        return Value::integer(bits);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return Value::real(value);
 }
 
-double PostfixExecutor::getValueFromLexeme(const Lexeme& lex) {
-    if (lex.type == LexemeType::Number) 
-    {
-        try 
-        {
-            return stod(lex.value);
+Value PostfixExecutor::evaluateChecked(const CompiledExpr& compiled) {
+    const vector<Lexeme>& rpn = compiled.rpn;
+    vector<Value> stk;
+    stk.reserve(rpn.size());
+
+    for (size_t i = 0; i < rpn.size(); ++i) {
+        const Lexeme& lex = rpn[i];
+        const TypedItem& item = compiled.items[i];
+
+        if (lex.type == LexemeType::Number) {
+            stk.push_back(item.literal);
         }
-        catch (...) 
-        {
-            throw runtime_error("Invalid numeric format in the lexeme: " + lex.value);
+        else if (lex.type == LexemeType::Identifier) {
+            // Тип разрешенного идентификатора известен заранее: чтение прямо из слота
+            if (item.type == ValueType::Integer)
+                stk.push_back(Value::integer(vartable->symbol(lex.slot).intValue));
+            else if (item.type == ValueType::Double)
+                stk.push_back(Value::real(vartable->symbol(lex.slot).doubleValue));
+            else
+                stk.push_back(getValueFromLexeme(lex));
         }
-    }
-    // Если лексема - идентификатор (переменная или константа)
-    else if (lex.type == LexemeType::Identifier) 
-    {
-        try 
-        {
-            // Сначала пытаемся получить как double (из doubletable).
-            return vartable->getDoubleConst(lex.value);
-        }
-        catch (const out_of_range&) 
-        { 
-            try 
-            {
-                return static_cast<double>(vartable->getIntConst(lex.value));
+        else if (lex.type == LexemeType::Operator) {
+            if (item.op == OperatorKind::Assign) {
+                throw runtime_error("Assignment operator (:=) should be handled by ProgramExecutor, not PostfixExecutor directly.");
             }
-            catch (const out_of_range&) 
-            { 
-                // Переменная/константа с таким именем не найдена ни в одной таблице.
-                throw runtime_error("Identifier '" + lex.value + "' isn't declared.");
+            if (stk.size() < 2) {
+                if (operatorInfo(item.op).comparison) throw runtime_error("Not enough operands for comparison.");
+                throw runtime_error("Not enough operands for operation: " + lex.value);
             }
+
+            Value rhs = stk.back(); stk.pop_back();
+            Value lhs = stk.back(); stk.pop_back();
+
+            ValueType type = item.type;
+            if (type == ValueType::Unknown)
+                type = operationType(item.op, lhs.type, rhs.type);
+            stk.push_back(applyOperation(item.op, type, lhs, rhs));
+        }
+        else {
+            throw runtime_error("Unexpected lexeme type in postfix expression: " + lex.value);
         }
     }
-    throw runtime_error("Incorrect lexeme to get the value: Type=" + std::to_string(static_cast<int>(lex.type)) + ", Value=" + lex.value);
-}
 
-double PostfixExecutor::evaluateOperation(const string& op, double lhs, double rhs) {
-    if (op == "+") return lhs + rhs;
-    if (op == "-") return lhs - rhs;
-    if (op == "*") return lhs * rhs;
-    if (op == "/") {
-        if (rhs == 0) throw runtime_error("Деление на ноль");
-        return lhs / rhs;
-    }
-    if (op == "div")
-    {
-        if (rhs == 0) throw runtime_error("Целочисленное деление на ноль");
-        return floor(lhs / rhs);
+    if (stk.empty()) {
+        return Value::real(0.0);
     }
-    if (op == "mod")
-    {
-        if (rhs == 0) throw runtime_error("Вычисление остатка (mod) от деления на ноль");
-        return fmod(lhs, rhs);
+    return stk.back();
+}
+
+// Выполнение операции в заданном типе (Integer - оба операнда integer)
+Value PostfixExecutor::applyOperation(OperatorKind op, ValueType type, const Value& lhs, const Value& rhs) {
+    OperationHandler handler = (type == ValueType::Integer ? IntHandlers : RealHandlers)[static_cast<size_t>(op)];
+    if (!handler) {
+        if (operatorInfo(op).comparison)
+            throw runtime_error("Неизвестный оператор сравнения: " + string(operatorInfo(op).text));
+        throw runtime_error("Неизвестный оператор: " + string(operatorInfo(op).text));
     }
+    return handler(lhs, rhs);
+}
 
-    throw runtime_error("Неизвестный оператор: " + op);
+Value PostfixExecutor::applyOperator(const string& op, const Value& lhs, const Value& rhs) {
+    return applyOperator(ClassifyOperator(op), lhs, rhs);
 }
 
-bool PostfixExecutor::evaluateCondition(const string& op, double lhs, double rhs) {
-    if (op == "=") return lhs == rhs;
-    if (op == "<>") return lhs != rhs;
-    if (op == "<") return lhs < rhs;
-    if (op == ">") return lhs > rhs;
-    if (op == "<=") return lhs <= rhs;
-    if (op == ">=") return lhs >= rhs;
+Value PostfixExecutor::applyOperator(OperatorKind op, const Value& lhs, const Value& rhs) {
+    return applyOperation(op, operationType(op, lhs.type, rhs.type), lhs, rhs);
+}
 
-    throw runtime_error("Неизвестный оператор сравнения: " + op);
+int PostfixExecutor::precedence(const string& op) {
+    return operatorInfo(ClassifyOperator(op)).precedence;
 }
 
-bool PostfixExecutor::isComparisonOperator(const string& op) {
-    return op == "=" || op == "<>" || op == "<" || op == ">" || op == "<="||  op == ">=";
-}
\ No newline at end of file
+Value PostfixExecutor::getValueFromLexeme(const Lexeme& lex) {
+    if (lex.type == LexemeType::Number) 
+    {
+        return NumberValue(lex);
+    }
+    // Если лексема - идентификатор (переменная или константа)
+    else if (lex.type == LexemeType::Identifier) 
+    {
+        // Разрешенный идентификатор читается прямо из слота, иначе слот ищется по имени
+        int slot = lex.slot >= 0 ? lex.slot : vartable->findSlot(lex.value);
+        if (slot < 0)
+        {
+            // Переменная/константа с таким именем не найдена ни в одной таблице.
+            throw runtime_error("Identifier '" + lex.value + "' isn't declared.");
+        }
+        const Symbol& symbol = vartable->symbol(slot);
+        return symbol.isInteger ? Value::integer(symbol.intValue) : Value::real(symbol.doubleValue);
+    }
+    throw runtime_error("Incorrect lexeme to get the value: Type=" + std::to_string(static_cast<int>(lex.type)) + ", Value=" + lex.value);
+}
@@ -1,7 +1,6 @@
 //#define DEBUG_EXECPRINT
 
 #include "program_executor.h"
-#include <limits>   
 #include <algorithm> //  std::transform, std::tolower
 #include <cctype>    //  isspace    
 
@@ -46,7 +45,18 @@ void ProgramExecutor::Execute(HLNode* head)
         throw std::runtime_error("Invalid program structure: MAIN_BLOCK is missing.");
     }
 
-    processNode(head); //    PROGRAM,     
+    //    PROGRAM,     .
+    // ,    ,   
+    try 
+    {
+        processNode(head);
+    }
+    catch (...) 
+    {
+        output.flush();
+        throw;
+    }
+    output.flush();
 }
 
 //        HLNode
@@ -74,7 +84,9 @@ void ProgramExecutor::processNode(HLNode* node)
             break;
 
         case NodeType::MAIN_BLOCK:
-            //   :    -  
+            //   :    -  .
+            //      ,     .
+            resolveSymbols(node->pdown);
             handleBlock(node); //       
             break;
 
@@ -149,211 +161,34 @@ void ProgramExecutor::handleBlock(HLNode* node)
 //    DECLARATION (   )
 void ProgramExecutor::handleDeclaration(HLNode* node)
 {
-    if (node->expr.empty())
-    {
-        throw std::runtime_error("Declaration node has empty expression vector.");
-    }
-
-    size_t endIndex = node->expr.size();
-    if (!node->expr.empty() && node->expr.back().type == LexemeType::Separator && node->expr.back().value == ";")
-    {
-        endIndex = node->expr.size() - 1; //    ';'   
-    }
-    else
-    {
-        endIndex = node->expr.size();
-    }
-
-    size_t currentPos = 0; //      node->expr
-
-    //      expr    
-    while (currentPos < endIndex)
+    forEachDeclarationItem(node, [&](const DeclarationItem& item)
     {
-        // 1.   /    
-        std::string varName = "";
-        size_t nameStartIndex = currentPos; //    
-
-        //      (     )
-        while (currentPos < endIndex && (node->expr[currentPos].type != LexemeType::Identifier) &&
-            !(node->expr[currentPos].type == LexemeType::Separator && node->expr[currentPos].value == ","))
-        {
-            currentPos++;
-        }
-
-        if (currentPos < endIndex && node->expr[currentPos].type == LexemeType::Identifier)
-        {
-            varName = node->expr[currentPos].value;
-            nameStartIndex = currentPos;
-            currentPos++; //   
-        }
-        else if (currentPos < endIndex && node->expr[currentPos].type == LexemeType::Separator && node->expr[currentPos].value == ",")
-        {
-            throw std::runtime_error("Syntax error in declaration: Unexpected ',' at position " + std::to_string(currentPos));
-        }
-        else
-        {
-            if (currentPos < endIndex)
-            {
-                throw std::runtime_error("Syntax error in declaration: Expected identifier at position " + std::to_string(currentPos));
-            }
-            break; // currentPos == endIndex,   
-        }
-
         //      
-        if (vartable.hasInt(varName) || vartable.hasDouble(varName))
-        {
-            throw std::runtime_error("Variable '" + varName + "' is already declared.");
-        }
-
-        // 2.    (=),  (:)    (,)   
-        size_t assignIndex = std::string::npos;
-        size_t typeIndex = std::string::npos;
-        size_t commaOrEndIndex = endIndex; //   ','  endIndex
-
-        for (size_t i = currentPos; i < endIndex; ++i)
+        if (vartable.lookup(item.name))
         {
-            if (node->expr[i].type == LexemeType::Separator && node->expr[i].value == ",")
-            {
-                commaOrEndIndex = i; //     ()
-                break;
-            }
-            if (node->expr[i].type == LexemeType::Operator && node->expr[i].value == "=" && assignIndex == std::string::npos)
-            {
-                assignIndex = i;
-            }
-            if (node->expr[i].type == LexemeType::Separator && node->expr[i].value == ":" && typeIndex == std::string::npos)
-            {
-                typeIndex = i;
-            }
+            throw std::runtime_error("Variable '" + item.name + "' is already declared.");
         }
-        // endOfCurrentDeclarationSegment   commaOrEndIndex
-
-       // 3.      
 
-        bool isConstant = (assignIndex != std::string::npos); //  ,   '='
-
-        //    ( '=')
-        if (isConstant)
+        if (item.isConstant)
         {
-            //   :  [: ] =  ;
-            //    ( ':')
-            std::string typeName = "";
-            if (typeIndex != std::string::npos && typeIndex < assignIndex) //  ':'   '='
-            {
-                //      
-                if (typeIndex + 1 >= assignIndex || node->expr[typeIndex + 1].type != LexemeType::VarType) {
-                    throw std::runtime_error("Syntax error in constant declaration: Missing or invalid type after ':' for '" + varName + "'");
-                }
-                typeName = node->expr[typeIndex + 1].value;
-                // ,     '='   
-                if (typeIndex + 2 < assignIndex) {
-                    throw std::runtime_error("Syntax error in constant declaration: Unexpected tokens between type and '=' for '" + varName + "'");
-                }
-            }
-            //    , typeIndex == std::string::npos  typeIndex > assignIndex ( )
-            else if (typeIndex != std::string::npos) {
-                //  ':'  '=',   
-                throw std::runtime_error("Syntax error in constant declaration: Type specifier after assignment for '" + varName + "'");
-            }
-
-            // ,   -  '='    (  endIndex)
-            if (assignIndex + 1 >= commaOrEndIndex) {
-                throw std::runtime_error("Missing value/expression for constant declaration: " + varName);
-            }
-
-            //      
-            std::vector<Lexeme> valueExpr;
-            for (size_t i = assignIndex + 1; i < commaOrEndIndex; ++i)
-            {
-                valueExpr.push_back(node->expr[i]);
-            }
-
-            //   
-            double result = executeExpression(valueExpr);
+            //    (  '='   )
+            Value result = evaluateOnce(node->expr, item.valueFirst, item.valueLast);
 
-            //    TableManager.
             //   ,  ,    double.
-            if (!typeName.empty()) {
-                if (typeName == "integer") {
-                    vartable.addInt(varName, static_cast<int>(result), true); //    int
-                }
-                else if (typeName == "double") {
-                    vartable.addDouble(varName, result, true); //    double
-                }
-                else {
-                    //    ,  Lexer   VarType
-                    throw std::runtime_error("Internal error: Unexpected VarType '" + typeName + "' for constant.");
-                }
-            }
-            else {
-                //    ,   double    
-                vartable.addDouble(varName, result, true); //    (true)
-            }
-
-        }
-        //     ( '='),     (':')
-        else if (typeIndex != std::string::npos)
-        {
-            //     :  :  ;
-             // ,     ':'   
-            if (nameStartIndex + 1 < typeIndex) {
-                throw std::runtime_error("Syntax error in variable declaration: Unexpected tokens after name '" + varName + "' before ':'");
-            }
-
-            //      
-            if (typeIndex + 1 >= commaOrEndIndex || node->expr[typeIndex + 1].type != LexemeType::VarType)
-            {
-                throw std::runtime_error("Missing or invalid type after ':' for variable: " + varName);
-            }
-            std::string typeName = node->expr[typeIndex + 1].value;
-
-            // ,         (  endIndex)
-            if (typeIndex + 2 < commaOrEndIndex)
-            {
-                throw std::runtime_error("Syntax error in variable declaration: Unexpected tokens after type for variable: " + varName);
-            }
-
-            if (typeName == "double")
-            {
-                vartable.addDouble(varName, 0.0, false); //    (false) double
-            }
-            else if (typeName == "integer")
-            {
-                vartable.addInt(varName, 0, false); //    (false) int
-            }
+            if (item.isInteger())
+                vartable.addInt(item.name, static_cast<int>(result.asInteger()), true); //    int
             else
-            {
-                //    
-                throw std::runtime_error("Unsupported variable type: " + typeName);
-            }
+                vartable.addDouble(item.name, result.asDouble(), true); //    double
         }
-        //    ,   -      ( int)
-        else
+        else if (item.isInteger())
         {
-            // ,       (  endIndex)   
-            if (nameStartIndex + 1 < commaOrEndIndex)
-            {
-                throw std::runtime_error("Syntax error in variable declaration: Unexpected token after variable name '" + varName + "'");
-            }
-            vartable.addInt(varName, 0, false); //    (false) int  
+            vartable.addInt(item.name, 0, false); //    (false) int
         }
-
-        // 4.       (     ',')
-        currentPos = commaOrEndIndex;
-        //      ,   .
-        if (currentPos < endIndex && node->expr[currentPos].type == LexemeType::Separator && node->expr[currentPos].value == ",")
+        else
         {
-            currentPos++; //  
+            vartable.addDouble(item.name, 0.0, false); //    (false) double
         }
-    }
-
-    // ,         endIndex
-    if (currentPos != endIndex)
-    {
-        //   ,       ,
-        //     .
-        throw std::runtime_error("Syntax error in declaration: Unexpected tokens after last variable/constant declaration.");
-    }
+    });
 }
 
 //    STATEMENT (  )
@@ -373,61 +208,47 @@ void ProgramExecutor::handleStatement(HLNode* node)
         std::string varName = node->expr[0].value; // 
 
         // ,   
-        if (!vartable.hasInt(varName) && !vartable.hasDouble(varName)) 
+        int slot = slotOf(node->expr[0]);
+        if (slot < 0) 
         {
             throw std::runtime_error("Attempt to assign to undeclared variable: " + varName);
         }
 
-        try 
-        {
-            if (vartable.isConstant(varName)) 
-            {
-                throw std::runtime_error("Attempt to assign to constant: '" + varName + "'");
-            }
-        }
-        catch (const out_of_range&) 
+        if (vartable.symbol(slot).isConstant) 
         {
-            //    ,     hasInt/hasDouble ,
-            //          Undeclared.
-            throw std::runtime_error("Internal error: Variable type or existence check failed for '" + varName + "'");
+            throw std::runtime_error("Attempt to assign to constant: '" + varName + "'");
         }
 
-        //      (  ':=')
-        std::vector<Lexeme> rhsExpr;
-        for (size_t i = 2; i < node->expr.size(); ++i)
+        //   -   ':='  ';' ( ;     expr   parseStatement).
+        //       ,   .
+        size_t rhsEnd = node->expr.size();
+        if (!node->compiled)
         {
-            //  ,   ';' ( ;     expr   parseStatement)
-            if (node->expr[i].type == LexemeType::Separator && node->expr[i].value == ";") 
-                break;
-            rhsExpr.push_back(node->expr[i]);
-        }
+            for (size_t i = 2; i < node->expr.size(); ++i)
+            {
+                if (node->expr[i].type == LexemeType::Separator && node->expr[i].value == ";")
+                {
+                    rhsEnd = i;
+                    break;
+                }
+            }
 
-        if (rhsExpr.empty()) 
-        {
-            throw std::runtime_error("Assignment statement has empty right-hand side for variable: " + varName);
+            if (rhsEnd <= 2)
+            {
+                throw std::runtime_error("Assignment statement has empty right-hand side for variable: " + varName);
+            }
         }
 
         //       PostfixExecutor
-        double result = executeExpression(rhsExpr);
+        Value result = executeExpression(node, 2, rhsEnd);
 
-        //      
-        if (vartable.hasInt(varName)) 
-        {
-            vartable.getInt(varName) = static_cast<int>(result);
-        }
-        else if (vartable.hasDouble(varName)) 
-        {
-            vartable.getDouble(varName) = result;
-        }
-        else 
-        { 
-            throw std::runtime_error("Internal error: Variable type changed unexpectedly for " + varName); 
-        }
+        //      (integer )
+        vartable.writeSlot(slot, result);
     }
     else 
     {
         //   . ,    ,   .
-        executeExpression(node->expr);
+        executeExpression(node);
         throw std::runtime_error("Expression used as statement without assignment.");
     }
 }
@@ -448,7 +269,7 @@ void ProgramExecutor::handleIfElse(HLNode* node)
     }
 
     //     PostfixExecutor
-    double conditionResultValue = executeExpression(node->expr);
+    double conditionResultValue = executeExpression(node).asDouble();
     bool conditionResult = (conditionResultValue != 0.0); //  ,     
 
     if (conditionResult) 
@@ -499,45 +320,36 @@ void ProgramExecutor::handleCall(HLNode* node)
         std::string varName = argNode->expr[0].value;
 
         // ,   
-        if (!vartable.hasInt(varName) && !vartable.hasDouble(varName)) 
+        int slot = slotOf(argNode->expr[0]);
+        if (slot < 0) 
         {
             throw std::runtime_error("Variable '" + varName + "' not declared before Read.");
         }
 
-        try 
-        {
-            if (vartable.isConstant(varName)) 
-            {
-                throw std::runtime_error("Attempt to read into constant: '" + varName + "'");
-            }
-        }
-        catch (const out_of_range&) 
+        if (vartable.symbol(slot).isConstant) 
         {
-            //   
-            throw std::runtime_error("Internal error: Variable type or existence check failed for '" + varName + "'");
+            throw std::runtime_error("Attempt to read into constant: '" + varName + "'");
         }
 
-
         double value;
         //    
-        std::cout << "Enter value for " << varName << ": ";
-        if (!(std::cin >> value)) 
+        if (prompts) 
+        {
+            output.write("Enter value for ");
+            output.write(varName);
+            output.write(": ");
+        }
+        //         
+        if (prompts || input->interactive())
+            output.flush();
+        //        
+        if (!input->next(value)) 
         {
-            //    (    )
-            std::cin.clear(); //   
-            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); //    
             throw std::runtime_error("Invalid input for Read statement. Expected a number.");
         }
 
-        //       TableManager
-        if (vartable.hasInt(varName)) 
-        {
-            vartable.getInt(varName) = static_cast<int>(value); //   int,   int
-        }
-        else if (vartable.hasDouble(varName)) 
-        {
-            vartable.getDouble(varName) = value; //   double
-        }
+        //      (  int,   int)
+        vartable.writeSlot(slot, value);
     }
     else if (functionName == "write") 
     {
@@ -550,23 +362,22 @@ void ProgramExecutor::handleCall(HLNode* node)
             }
 
             if (!isFirstArg) { //     ,    
-                std::cout << " ";
+                output.write(' ');
             }
 
             if (!currentArgNode->expr.empty()) {
                 if (currentArgNode->expr.size() == 1 && currentArgNode->expr[0].type == LexemeType::StringLiteral) {
-                    std::cout << currentArgNode->expr[0].value;
+                    output.write(currentArgNode->expr[0].value);
                 }
                 else {
-                    double result = executeExpression(currentArgNode->expr);
-                    std::cout << result;
+                    output.writeNumber(executeExpression(currentArgNode).asDouble());
                 }
             }
 
             isFirstArg = false; //    ,  
             currentArgNode = currentArgNode->pnext; //    
         }
-        std::cout << std::endl; //   
+        output.write('\n'); //     :  -   
     }
     else 
     {
@@ -574,18 +385,53 @@ void ProgramExecutor::handleCall(HLNode* node)
     }
 }
 
-//        PostfixExecutor
-double ProgramExecutor::executeExpression(const vector<Lexeme>& expr) 
+//          
+void ProgramExecutor::resolveSymbols(HLNode* firstNode)
+{
+    for (HLNode* node = firstNode; node; node = node->pnext)
+    {
+        for (Lexeme& lex : node->expr)
+        {
+            if (lex.type == LexemeType::Identifier)
+                lex.slot = vartable.findSlot(lex.value); //     -1  
+        }
+        if (node->pdown)
+            resolveSymbols(node->pdown);
+    }
+}
+
+int ProgramExecutor::slotOf(const Lexeme& lex) const
+{
+    return lex.slot >= 0 ? lex.slot : vartable.findSlot(lex.value);
+}
+
+//         PostfixExecutor
+Value ProgramExecutor::executeExpression(HLNode* node, size_t first, size_t last) 
 {
-    //   ,       PostfixExecutor.
-    // PostfixExecutor::buildPostfix  HLNode*.
-    //  NodeType::STATEMENT,       PostfixExecutor
-    //     -> .
-    HLNode tempExprNode(NodeType::STATEMENT, expr);
+    //            ;
+    //        .
+    if (!node->compiled)
+    {
+        CompiledExpr* compiled = new CompiledExpr();
+        try
+        {
+            postfix.compile(node->expr, first, last, *compiled);
+        }
+        catch (...)
+        {
+            delete compiled;
+            throw;
+        }
+        node->compiled = compiled;
+    }
 
-    //      
-    postfix.toPostfix(&tempExprNode);
+    return postfix.executeTyped(*node->compiled);
+}
 
-    //      
-    return postfix.executePostfix();
+//       
+Value ProgramExecutor::evaluateOnce(const vector<Lexeme>& expr, size_t first, size_t last)
+{
+    CompiledExpr compiled;
+    postfix.compile(expr, first, last, compiled);
+    return postfix.executeTyped(compiled);
 }
@@ -0,0 +1,102 @@
+﻿#include "source_file.h"
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+// Без mmap: файл читается один раз прямо в строку нужного размера
+SourceFile::SourceFile(const string& path) {
+    if (path == "-") {
+        buffer.assign(istreambuf_iterator<char>(cin), istreambuf_iterator<char>());
+    }
+    else {
+        ifstream file(path, ios::binary | ios::ate);
+        if (!file.is_open())
+            throw runtime_error("Could not open file '" + path + "'.");
+        buffer.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(&buffer[0], static_cast<streamsize>(buffer.size()));
+    }
+    view = buffer;
+}
+
+SourceFile::~SourceFile() {}
+
+#else
+
+SourceFile::SourceFile(const string& path) {
+    if (path == "-") {
+        readAll(STDIN_FILENO, 0);
+        return;
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw runtime_error("Could not open file '" + path + "': " + strerror(errno) + ".");
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        size_t size = static_cast<size_t>(info.st_size);
+        void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            madvise(address, size, MADV_SEQUENTIAL); // Лексер читает текст один раз подряд
+            mapping = address;
+            mappingSize = size;
+            view = string_view(static_cast<const char*>(address), size);
+            loadMethod = LoadMethod::Mapped;
+            ::close(fd); // Отображение остается действительным после закрытия файла
+            return;
+        }
+    }
+
+    // Канал, устройство или отказ mmap: читаем обычным образом
+    try {
+        readAll(fd, S_ISREG(info.st_mode) ? static_cast<size_t>(info.st_size) : 0);
+    }
+    catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+}
+
+SourceFile::~SourceFile() {
+    if (mapping)
+        munmap(mapping, mappingSize);
+}
+
+void SourceFile::readAll(int fd, size_t sizeHint) {
+    const size_t ChunkSize = 64 * 1024;
+    buffer.reserve(sizeHint + 1);
+    size_t length = 0;
+    for (;;) {
+        if (buffer.size() < length + ChunkSize)
+            buffer.resize(length + ChunkSize);
+        ssize_t count = ::read(fd, &buffer[length], ChunkSize);
+        if (count < 0) {
+            if (errno == EINTR)
+                continue;
+            throw runtime_error(string("Could not read source: ") + strerror(errno) + ".");
+        }
+        if (count == 0)
+            break;
+        length += static_cast<size_t>(count);
+    }
+    buffer.resize(length);
+    view = buffer;
+    loadMethod = LoadMethod::Read;
+}
+
+#endif
@@ -2,63 +2,104 @@
 
 using namespace std;
 
-bool TableManager::addInt(const std::string& name, int val, bool isConstant)
+template <template <typename, typename> class THashTable>
+bool TTableManager<THashTable>::addSymbol(const Symbol& symbol)
 {
-    if (hasDouble(name)) 
+    //  : Insert  ,       
+    if (!table.Insert(symbol.name, static_cast<int>(symbols.size()), symbol.isConstant))
     {
         return false; //  false,     
     }
-    return inttable.Insert(name, val, isConstant);
+    symbols.push_back(symbol);
+    return true;
 }
 
-bool TableManager::addDouble(const std::string& name, double val, bool isConstant)
+template <template <typename, typename> class THashTable>
+bool TTableManager<THashTable>::addInt(const std::string& name, int val, bool isConstant)
 {
-    if (hasInt(name)) 
-    {
-        return false; //  false,     
-    }
-    return doubletable.Insert(name, val, isConstant);
+    return addSymbol({ name, true, isConstant, val, 0.0 });
 }
 
-int& TableManager::getInt(string name)
+template <template <typename, typename> class THashTable>
+bool TTableManager<THashTable>::addDouble(const std::string& name, double val, bool isConstant)
 {
-    return inttable[name];
+    return addSymbol({ name, false, isConstant, 0, val });
 }
 
-double& TableManager::getDouble(string name)
+template <template <typename, typename> class THashTable>
+Symbol& TTableManager<THashTable>::typed(const string& name, bool isInteger)
 {
-    return doubletable[name];
+    Symbol* symbol = lookup(name);
+    if (!symbol || symbol->isInteger != isInteger)
+        throw out_of_range("Key not found in hash table: " + name);
+    if (symbol->isConstant)
+        throw std::runtime_error("Attempt to modify constant: " + name);
+    return *symbol;
 }
 
-const int& TableManager::getIntConst(string name) const
+template <template <typename, typename> class THashTable>
+const Symbol& TTableManager<THashTable>::typed(const string& name, bool isInteger) const
 {
-    return inttable[name];
+    const Symbol* symbol = lookup(name);
+    if (!symbol || symbol->isInteger != isInteger)
+        throw out_of_range("Key not found in hash table: " + name);
+    return *symbol;
 }
 
-const double& TableManager::getDoubleConst(string name) const
+template <template <typename, typename> class THashTable>
+int& TTableManager<THashTable>::getInt(string name)
 {
-    return doubletable[name];
+    return typed(name, true).intValue;
 }
 
-bool TableManager::isConstant(const std::string& name) const
+template <template <typename, typename> class THashTable>
+double& TTableManager<THashTable>::getDouble(string name)
 {
-    //      int   
-    try {
-        //      inttable, inttable.IsConstant  out_of_range.
-        return inttable.IsConstant(name);
-    }
-    catch (const out_of_range&) {
-        //      int,      double.
-    }
+    return typed(name, false).doubleValue;
+}
 
-    //      int,     double   
-    try {
-        //    IsConstant  doubletable
-        return doubletable.IsConstant(name);
-    }
-    catch (const out_of_range&) {
-        //       double (      int),
-        // ,    .  .
-        throw out_of_range("Variable or constant '" + name + "' not found."); 
-    }
-}
\ No newline at end of file
+template <template <typename, typename> class THashTable>
+const int& TTableManager<THashTable>::getIntConst(string name) const
+{
+    return typed(name, true).intValue;
+}
+
+template <template <typename, typename> class THashTable>
+const double& TTableManager<THashTable>::getDoubleConst(string name) const
+{
+    return typed(name, false).doubleValue;
+}
+
+template <template <typename, typename> class THashTable>
+bool TTableManager<THashTable>::isConstant(const std::string& name) const
+{
+    if (const Symbol* symbol = lookup(name))
+        return symbol->isConstant;
+    //   
+    throw out_of_range("Variable or constant '" + name + "' not found."); 
+}
+
+template <template <typename, typename> class THashTable>
+const Symbol* TTableManager<THashTable>::lookup(const std::string& name) const
+{
+    const int* slot = table.Find(name);
+    return slot ? &symbols[*slot] : nullptr;
+}
+
+template <template <typename, typename> class THashTable>
+Symbol* TTableManager<THashTable>::lookup(const std::string& name)
+{
+    const int* slot = table.Find(name);
+    return slot ? &symbols[*slot] : nullptr;
+}
+
+template <template <typename, typename> class THashTable>
+int TTableManager<THashTable>::findSlot(const std::string& name) const
+{
+    const int* slot = table.Find(name);
+    return slot ? *slot : -1;
+}
+
+//      -
+template class TTableManager<THashTableChain>;
+template class TTableManager<THashTableOpen>;
@@ -0,0 +1,623 @@
+﻿#include "transpiler.h"
+#include "declaration.h"
+#include "operators.h"
+
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    // Поддержка времени выполнения, встраиваемая в каждую сгенерированную программу.
+    // Формат чисел и разбор ввода повторяют FormatNumber и ParseNumber интерпретатора.
+    const char* const RuntimePrelude = R"(#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace rt
+{
+    inline char output[1 << 16];
+    inline size_t used = 0;
+    inline bool interactive = false;
+    inline bool prompts = false;
+
+    inline void flush()
+    {
+        std::fwrite(output, 1, used, stdout);
+        used = 0;
+        std::fflush(stdout);
+    }
+
+    inline void write(const char* text, size_t length)
+    {
+        if (used + length > sizeof(output)) {
+            std::fwrite(output, 1, used, stdout);
+            used = 0;
+            if (length > sizeof(output)) {
+                std::fwrite(text, 1, length, stdout);
+                return;
+            }
+        }
+        std::memcpy(output + used, text, length);
+        used += length;
+    }
+
+    inline void writeNumber(double value)
+    {
+        char text[32];
+        char* end = nullptr;
+        if (value > -1e6 && value < 1e6) {
+            long long whole = static_cast<long long>(value);
+            if (static_cast<double>(whole) == value && !(whole == 0 && std::signbit(value)))
+                end = std::to_chars(text, text + sizeof(text), whole).ptr;
+        }
+        if (!end)
+            end = std::to_chars(text, text + sizeof(text), value, std::chars_format::general, 6).ptr;
+        write(text, static_cast<size_t>(end - text));
+    }
+
+    // Как у интерпретатора: приглашения по умолчанию только при вводе с терминала,
+    // --prompt и --no-prompt задают их явно
+    inline void init(int argc, char** argv)
+    {
+#ifdef _WIN32
+        interactive = _isatty(0) != 0;
+#else
+        interactive = isatty(0) != 0;
+#endif
+        prompts = interactive;
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--prompt") == 0)
+                prompts = true;
+            else if (std::strcmp(argv[i], "--no-prompt") == 0)
+                prompts = false;
+        }
+    }
+
+    [[noreturn]] inline void fail(const char* message)
+    {
+        flush();
+        std::fprintf(stderr, "error: %s\n", message);
+        std::exit(1);
+    }
+
+    inline bool isSpace(int c)
+    {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    inline bool parseNumber(const char* first, const char* last, double& value)
+    {
+        if (first != last && *first == '+') {
+            ++first;
+            if (first != last && *first == '-')
+                return false;
+        }
+        const char* digits = first != last && *first == '-' ? first + 1 : first;
+        if (digits == last || !((*digits >= '0' && *digits <= '9') || *digits == '.'))
+            return false;
+        auto [ptr, ec] = std::from_chars(first, last, value);
+        return ec == std::errc() && ptr == last;
+    }
+
+    inline double read(const char* name)
+    {
+        if (prompts) {
+            write("Enter value for ", 16);
+            write(name, std::strlen(name));
+            write(": ", 2);
+        }
+        // Приглашение и предыдущий вывод должны появиться до ожидания ввода
+        if (prompts || interactive)
+            flush();
+        int c = std::getchar();
+        while (c != EOF && isSpace(c))
+            c = std::getchar();
+        char token[128];
+        size_t length = 0;
+        bool tooLong = false;
+        while (c != EOF && !isSpace(c)) {
+            if (length < sizeof(token))
+                token[length++] = static_cast<char>(c);
+            else
+                tooLong = true;
+            c = std::getchar();
+        }
+        double value;
+        if (length == 0 || tooLong || !parseNumber(token, token + length, value))
+            fail("Invalid input for Read statement. Expected a number.");
+        return value;
+    }
+
+    typedef unsigned long long ull;
+
+    inline long long add(long long a, long long b) { return static_cast<long long>(static_cast<ull>(a) + static_cast<ull>(b)); }
+    inline long long sub(long long a, long long b) { return static_cast<long long>(static_cast<ull>(a) - static_cast<ull>(b)); }
+    inline long long mul(long long a, long long b) { return static_cast<long long>(static_cast<ull>(a) * static_cast<ull>(b)); }
+)";
+
+    // Вторая часть поддержки: операции, ошибки которых используют сообщения интерпретатора
+    string runtimeOperations()
+    {
+        const string divisionByZero = CppStringLiteral(DivisionByZeroMessage);
+        const string intDivisionByZero = CppStringLiteral(IntDivisionByZeroMessage);
+        const string modByZero = CppStringLiteral(ModByZeroMessage);
+        return
+            "\n"
+            "    inline long long intDiv(long long a, long long b)\n"
+            "    {\n"
+            "        if (b == 0) fail(" + intDivisionByZero + ");\n"
+            "        if (b == -1) return static_cast<long long>(0 - static_cast<ull>(a));\n"
+            "        long long q = a / b;\n"
+            "        if (a % b != 0 && ((a < 0) != (b < 0))) --q;\n"
+            "        return q;\n"
+            "    }\n"
+            "\n"
+            "    inline long long intMod(long long a, long long b)\n"
+            "    {\n"
+            "        if (b == 0) fail(" + modByZero + ");\n"
+            "        if (b == -1) return 0;\n"
+            "        return a % b;\n"
+            "    }\n"
+            "\n"
+            "    inline double divide(double a, double b)\n"
+            "    {\n"
+            "        if (b == 0) fail(" + divisionByZero + ");\n"
+            "        return a / b;\n"
+            "    }\n"
+            "\n"
+            "    inline double realIntDiv(double a, double b)\n"
+            "    {\n"
+            "        if (b == 0) fail(" + intDivisionByZero + ");\n"
+            "        return std::floor(a / b);\n"
+            "    }\n"
+            "\n"
+            "    inline double realMod(double a, double b)\n"
+            "    {\n"
+            "        if (b == 0) fail(" + modByZero + ");\n"
+            "        return std::fmod(a, b);\n"
+            "    }\n"
+            "}\n";
+    }
+
+    // Литерал C++ того же типа и значения (double - кратчайшая точная запись)
+    string literal(const Value& value)
+    {
+        if (value.isInteger()) {
+            if (value.intValue == LLONG_MIN)
+                return "(-9223372036854775807LL - 1)";
+            string text = to_string(value.intValue) + "LL";
+            return value.intValue < 0 ? "(" + text + ")" : text;
+        }
+        double d = value.doubleValue;
+        if (isnan(d))
+            return "std::numeric_limits<double>::quiet_NaN()";
+        if (isinf(d))
+            return d > 0 ? "std::numeric_limits<double>::infinity()" : "(-std::numeric_limits<double>::infinity())";
+        char text[64];
+        string result(text, to_chars(text, text + sizeof(text), d).ptr);
+        if (result.find_first_of(".e") == string::npos)
+            result += ".0";
+        return signbit(d) ? "(" + result + ")" : result;
+    }
+
+    string variableName(const string& name)
+    {
+        return "v_" + name;
+    }
+
+    string asDouble(const string& code, ValueType type)
+    {
+        return type == ValueType::Integer ? "static_cast<double>(" + code + ")" : code;
+    }
+
+    const char* cppComparison(OperatorKind kind)
+    {
+        switch (kind) {
+        case OperatorKind::Eq: return "==";
+        case OperatorKind::Ne: return "!=";
+        case OperatorKind::Lt: return "<";
+        case OperatorKind::Gt: return ">";
+        case OperatorKind::Le: return "<=";
+        default: return ">=";
+        }
+    }
+}
+
+string CppStringLiteral(const string& text)
+{
+    string result = "\"";
+    for (unsigned char c : text) {
+        switch (c) {
+        case '"': result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '?': result += "\\?"; break;
+        case '\n': result += "\\n"; break;
+        case '\t': result += "\\t"; break;
+        default:
+            if (c < 0x20 || c >= 0x7F) {
+                // Восьмеричная запись не длиннее трех цифр и не захватывает следующий символ
+                result += '\\';
+                result += static_cast<char>('0' + (c >> 6));
+                result += static_cast<char>('0' + ((c >> 3) & 7));
+                result += static_cast<char>('0' + (c & 7));
+            }
+            else {
+                result += static_cast<char>(c);
+            }
+        }
+    }
+    return result + "\"";
+}
+
+void CppTranspiler::line(const string& text) {
+    body.append(4 * static_cast<size_t>(indent + 1), ' ');
+    body += text;
+    body += '\n';
+}
+
+void CppTranspiler::emitFail(const string& message) {
+    line("rt::fail(" + CppStringLiteral(message) + ");");
+}
+
+string CppTranspiler::temporary(ValueType type, const string& code) {
+    string name = "t" + to_string(++temporaries);
+    line(string(type == ValueType::Integer ? "const long long " : "const double ") + name + " = " + code + ";");
+    return name;
+}
+
+string CppTranspiler::Translate(HLNode* head) {
+    // Те же проверки структуры, что и в ProgramExecutor::Execute
+    if (!head || head->type != NodeType::PROGRAM) {
+        throw std::runtime_error("Invalid program structure: Root node is missing or not of type PROGRAM.");
+    }
+
+    HLNode* mainBlock = nullptr;
+    for (HLNode* child = head->pdown; child; child = child->pnext) {
+        if (child->type == NodeType::MAIN_BLOCK) {
+            mainBlock = child;
+        }
+        else if (!mainBlock) {
+            if (child->type != NodeType::CONST_SECTION && child->type != NodeType::VAR_SECTION) {
+                throw std::runtime_error("Invalid program structure: Unexpected node type (" + std::string(NodeTypeToString(child->type)) + ") before MAIN_BLOCK.");
+            }
+        }
+        else {
+            throw std::runtime_error("Invalid program structure: Unexpected node type (" + std::string(NodeTypeToString(child->type)) + ") after MAIN_BLOCK.");
+        }
+    }
+    if (!mainBlock) {
+        throw std::runtime_error("Invalid program structure: MAIN_BLOCK is missing.");
+    }
+
+    decltable = TableManager();
+    body.clear();
+    indent = 0;
+    temporaries = 0;
+
+    for (HLNode* child = head->pdown; child != mainBlock; child = child->pnext) {
+        translateDeclarations(child);
+    }
+    translateBlock(mainBlock->pdown);
+
+    return string("// Generated by pascal --emit-cpp. Build: c++ -std=c++17 -O2 <file> -o <program>\n"
+        "// Read takes numbers from stdin. 'Enter value for x:' prompts are shown only when stdin\n"
+        "// is a terminal; --prompt and --no-prompt force them on or off.\n\n")
+        + RuntimePrelude + runtimeOperations() +
+        "\n"
+        "int main(int argc, char** argv)\n"
+        "{\n"
+        "    rt::init(argc, argv);\n"
+        "\n"
+        + body +
+        "\n"
+        "    rt::flush();\n"
+        "    return 0;\n"
+        "}\n";
+}
+
+void CppTranspiler::translateDeclarations(HLNode* section) {
+    for (HLNode* decl = section->pdown; decl; decl = decl->pnext) {
+        if (decl->type != NodeType::DECLARATION) {
+            throw std::runtime_error("Transpiler: unexpected node type (" + std::string(NodeTypeToString(decl->type)) + ") in declaration section.");
+        }
+
+        forEachDeclarationItem(decl, [&](const DeclarationItem& item) {
+            if (decltable.lookup(item.name)) {
+                throw std::runtime_error("Variable '" + item.name + "' is already declared.");
+            }
+
+            if (item.isConstant) {
+                // Значение вычисляется так же, как ProgramExecutor::handleDeclaration (переменные в нем равны 0)
+                CompiledExpr value;
+                postfix.compile(decl->expr, item.valueFirst, item.valueLast, value);
+                Value result = postfix.executeTyped(value);
+                if (item.isInteger())
+                    decltable.addInt(item.name, static_cast<int>(result.asInteger()), true);
+                else
+                    decltable.addDouble(item.name, result.asDouble(), true);
+            }
+            else if (item.isInteger()) {
+                decltable.addInt(item.name, 0, false);
+                line("int " + variableName(item.name) + " = 0;");
+            }
+            else {
+                decltable.addDouble(item.name, 0.0, false);
+                line("double " + variableName(item.name) + " = 0.0;");
+            }
+        });
+    }
+}
+
+void CppTranspiler::translateBlock(HLNode* first) {
+    HLNode* current = first;
+    while (current) {
+        current = translateNode(current);
+    }
+}
+
+HLNode* CppTranspiler::translateNode(HLNode* node) {
+    switch (node->type) {
+    case NodeType::STATEMENT:
+        translateStatement(node);
+        break;
+
+    case NodeType::IF:
+        translateIf(node);
+        // ELSE, следующий за IF, уже оттранслирован вместе с ним
+        if (node->pnext && node->pnext->type == NodeType::ELSE)
+            return node->pnext->pnext;
+        break;
+
+    case NodeType::ELSE:
+        // ELSE без предшествующего IF
+        if (node->pdown) emitFail("Attempted to process ELSE node directly.");
+        break;
+
+    case NodeType::CALL:
+        translateCall(node);
+        break;
+
+    case NodeType::PROGRAM:
+    case NodeType::MAIN_BLOCK:
+        translateBlock(node->pdown);
+        break;
+
+    default:
+        throw std::runtime_error("Transpiler: unsupported node type (" + std::string(NodeTypeToString(node->type)) + ") inside a block.");
+    }
+    return node->pnext;
+}
+
+void CppTranspiler::translateStatement(HLNode* node) {
+    const vector<Lexeme>& expr = node->expr;
+    if (expr.empty()) {
+        emitFail("Statement node has empty expression.");
+        return;
+    }
+
+    if (expr[0].type == LexemeType::Identifier && expr.size() > 1 &&
+        expr[1].type == LexemeType::Operator && expr[1].value == ":=") {
+        const string& varName = expr[0].value;
+
+        const Symbol* symbol = decltable.lookup(varName);
+        if (!symbol) {
+            emitFail("Attempt to assign to undeclared variable: " + varName);
+            return;
+        }
+        if (symbol->isConstant) {
+            emitFail("Attempt to assign to constant: '" + varName + "'");
+            return;
+        }
+
+        size_t rhsEnd = expr.size();
+        for (size_t i = 2; i < expr.size(); ++i) {
+            if (expr[i].type == LexemeType::Separator && expr[i].value == ";") {
+                rhsEnd = i;
+                break;
+            }
+        }
+        if (rhsEnd <= 2) {
+            emitFail("Assignment statement has empty right-hand side for variable: " + varName);
+            return;
+        }
+
+        CppValue value = translateExpression(expr, 2, rhsEnd);
+        // Как TableManager::writeSlot: integer-переменная получает усеченное значение
+        if (!symbol->isInteger)
+            line(variableName(varName) + " = " + asDouble(value.code, value.type) + ";");
+        else if (value.type == ValueType::Integer)
+            line(variableName(varName) + " = static_cast<int>(" + value.code + ");");
+        else
+            line(variableName(varName) + " = static_cast<int>(static_cast<long long>(" + value.code + "));");
+    }
+    else {
+        // Выражение без присваивания: вычисляется (ошибки вычисления имеют приоритет), затем ошибка
+        translateExpression(expr, 0, expr.size());
+        emitFail("Expression used as statement without assignment.");
+    }
+}
+
+void CppTranspiler::translateIf(HLNode* node) {
+    if (node->expr.empty()) {
+        emitFail("IF node has empty condition expression.");
+        return;
+    }
+
+    CppValue condition = translateExpression(node->expr, 0, node->expr.size());
+    line("if (" + asDouble(condition.code, condition.type) + " != 0.0) {");
+    ++indent;
+    translateBlock(node->pdown);
+    --indent;
+
+    HLNode* elseNode = node->pnext;
+    if (elseNode && elseNode->type == NodeType::ELSE && elseNode->pdown) {
+        line("}");
+        line("else {");
+        ++indent;
+        translateBlock(elseNode->pdown);
+        --indent;
+    }
+    line("}");
+}
+
+void CppTranspiler::translateCall(HLNode* node) {
+    if (node->expr.empty() || node->expr[0].type != LexemeType::Keyword) {
+        emitFail("Invalid CALL node: function name missing or not a keyword.");
+        return;
+    }
+
+    const string& functionName = node->expr[0].value;
+
+    if (functionName == "read") {
+        HLNode* argNode = node->pdown;
+        if (!argNode || argNode->pnext != nullptr ||
+            argNode->type != NodeType::STATEMENT || argNode->expr.size() != 1 || argNode->expr[0].type != LexemeType::Identifier) {
+            emitFail("Invalid Read statement format. Expected: read(identifier);");
+            return;
+        }
+        const string& varName = argNode->expr[0].value;
+
+        const Symbol* symbol = decltable.lookup(varName);
+        if (!symbol) {
+            emitFail("Variable '" + varName + "' not declared before Read.");
+            return;
+        }
+        if (symbol->isConstant) {
+            emitFail("Attempt to read into constant: '" + varName + "'");
+            return;
+        }
+        string read = "rt::read(" + CppStringLiteral(varName) + ")";
+        line(variableName(varName) + " = " + (symbol->isInteger ? "static_cast<int>(" + read + ")" : read) + ";");
+    }
+    else if (functionName == "write") {
+        bool isFirstArg = true;
+        for (HLNode* arg = node->pdown; arg; arg = arg->pnext) {
+            if (arg->type != NodeType::STATEMENT) {
+                emitFail("Invalid Write statement format: expected STATEMENT node for argument.");
+                return;
+            }
+
+            if (!isFirstArg) line("rt::write(\" \", 1);");
+
+            if (!arg->expr.empty()) {
+                if (arg->expr.size() == 1 && arg->expr[0].type == LexemeType::StringLiteral) {
+                    const string& text = arg->expr[0].value;
+                    line("rt::write(" + CppStringLiteral(text) + ", " + to_string(text.size()) + ");");
+                }
+                else {
+                    CppValue value = translateExpression(arg->expr, 0, arg->expr.size());
+                    line("rt::writeNumber(" + asDouble(value.code, value.type) + ");");
+                }
+            }
+            isFirstArg = false;
+        }
+        line("rt::write(\"\\n\", 1);");
+    }
+    else {
+        emitFail("Unsupported function call: '" + functionName + "'");
+    }
+}
+
+CppTranspiler::CppValue CppTranspiler::translateExpression(const vector<Lexeme>& expr, size_t first, size_t last) {
+    const CppValue failed{ "0.0", ValueType::Double };
+
+    CompiledExpr rpn;
+    try {
+        postfix.compile(expr, first, last, rpn);
+    }
+    catch (const std::exception& e) {
+        emitFail(e.what());
+        return failed;
+    }
+
+    // Каждая операция - отдельная временная константа: порядок вычисления (и первой ошибки)
+    // совпадает с постфиксной записью, а не с неуточненным порядком аргументов C++
+    vector<CppValue> stack;
+    for (size_t i = 0; i < rpn.rpn.size(); ++i) {
+        const Lexeme& lex = rpn.rpn[i];
+        const TypedItem& item = rpn.items[i];
+
+        if (lex.type == LexemeType::Number) {
+            stack.push_back({ literal(item.literal), item.literal.type });
+        }
+        else if (lex.type == LexemeType::Identifier) {
+            const Symbol* symbol = decltable.lookup(lex.value);
+            if (!symbol) {
+                emitFail("Identifier '" + lex.value + "' isn't declared.");
+                return failed;
+            }
+            ValueType type = symbol->isInteger ? ValueType::Integer : ValueType::Double;
+            if (symbol->isConstant)
+                stack.push_back({ literal(symbol->isInteger ? Value::integer(symbol->intValue) : Value::real(symbol->doubleValue)), type });
+            else
+                stack.push_back({ variableName(lex.value), type });
+        }
+        else if (lex.type == LexemeType::Operator) {
+            OperatorKind kind = item.op;
+            if (kind == OperatorKind::Assign) {
+                emitFail("Assignment operator (:=) should be handled by ProgramExecutor, not PostfixExecutor directly.");
+                return failed;
+            }
+            if (stack.size() < 2) {
+                emitFail(operatorInfo(kind).comparison ? "Not enough operands for comparison." : "Not enough operands for operation: " + lex.value);
+                return failed;
+            }
+            if (kind < OperatorKind::Add || kind > OperatorKind::Ge) {
+                emitFail("Неизвестный оператор: " + lex.value);
+                return failed;
+            }
+
+            CppValue rhs = stack.back(); stack.pop_back();
+            CppValue lhs = stack.back(); stack.pop_back();
+            // Типы операндов здесь всегда известны (как в PostfixExecutor::operationType)
+            bool integer = kind != OperatorKind::Div && lhs.type == ValueType::Integer && rhs.type == ValueType::Integer;
+            ValueType type = integer ? ValueType::Integer : ValueType::Double;
+
+            if (operatorInfo(kind).comparison) {
+                string a = integer ? lhs.code : asDouble(lhs.code, lhs.type);
+                string b = integer ? rhs.code : asDouble(rhs.code, rhs.type);
+                stack.push_back({ temporary(ValueType::Integer,
+                    "static_cast<long long>(" + a + " " + cppComparison(kind) + " " + b + ")"), ValueType::Integer });
+                continue;
+            }
+
+            string code;
+            if (integer) {
+                static const char* const functions[] = { "rt::add", "rt::sub", "rt::mul", "", "rt::intDiv", "rt::intMod" };
+                code = string(functions[static_cast<size_t>(kind) - static_cast<size_t>(OperatorKind::Add)]) + "(" + lhs.code + ", " + rhs.code + ")";
+            }
+            else {
+                string a = asDouble(lhs.code, lhs.type);
+                string b = asDouble(rhs.code, rhs.type);
+                switch (kind) {
+                case OperatorKind::Add: code = a + " + " + b; break;
+                case OperatorKind::Sub: code = a + " - " + b; break;
+                case OperatorKind::Mul: code = a + " * " + b; break;
+                case OperatorKind::Div: code = "rt::divide(" + a + ", " + b + ")"; break;
+                case OperatorKind::IntDiv: code = "rt::realIntDiv(" + a + ", " + b + ")"; break;
+                default: code = "rt::realMod(" + a + ", " + b + ")"; break;
+                }
+            }
+            stack.push_back({ temporary(type, code), type });
+        }
+        else {
+            emitFail("Unexpected lexeme type in postfix expression: " + lex.value);
+            return failed;
+        }
+    }
+
+    // Пустое выражение дает 0, из нескольких значений результатом служит верхнее
+    if (stack.empty())
+        return failed;
+    return stack.back();
+}
@@ -0,0 +1,282 @@
+﻿#include "gtest.h"
+#include "bytecode.h"
+#include "program_executor.h"
+#include "parser.h"
+#include "lexer.h"
+#include "input_source.h"
+
+#include <sstream>
+#include <string>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    // Результат запуска программы: весь вывод и текст ошибки (если была)
+    struct RunResult
+    {
+        string output;
+        string error;
+    };
+
+    // Выполняет программу заданным исполнителем с выводом в строку и вводом из input
+    template <typename TExecutor>
+    RunResult runProgram(const string& source, const string& input = "")
+    {
+        Lexer lexer;
+        vector<Lexeme> lexemes = lexer.Tokenize(source);
+        Parser parser;
+        HLNode* tree = parser.BuildHList(lexemes);
+
+        ostringstream out;
+        BufferInputSource in(input);
+        RunResult result;
+        try {
+            TExecutor executor(out);
+            executor.setInput(in);
+            executor.Execute(tree);
+        }
+        catch (const runtime_error& e) {
+            result.error = e.what();
+        }
+        delete tree;
+
+        result.output = out.str();
+        return result;
+    }
+
+    // Сравнивает байт-код с обходом дерева на одной и той же программе
+    void expectSameBehaviour(const string& source, const string& input = "")
+    {
+        RunResult tree = runProgram<ProgramExecutor>(source, input);
+        RunResult vm = runProgram<BytecodeExecutor>(source, input);
+        EXPECT_EQ(vm.output, tree.output);
+        EXPECT_EQ(vm.error, tree.error);
+    }
+}
+
+TEST(BytecodeTest, arithmetic_matches_tree_walker)
+{
+    expectSameBehaviour(R"(
+    program Arith;
+    const
+        K = 3;
+        Half : double = 0.5;
+    var
+        a, b : integer;
+        x : double;
+    begin
+        a := 7;
+        b := a div 2 + a mod 4 * K;
+        x := (a - b) / 4 + Half;
+        Write(a, b, x, a * (b - 1) - 2);
+        b := x * 3;
+        Write("b = ", b);
+    end.)");
+}
+
+TEST(BytecodeTest, nested_if_else_matches_tree_walker)
+{
+    string source = R"(
+    program Branches;
+    var
+        n : integer;
+    begin
+        Read(n);
+        if n > 10 then
+            begin
+            if n mod 2 = 0 then
+                begin
+                Write("big even");
+                end
+            else
+                Write("big odd");
+            end
+        else
+            Write("small");
+        if n <> 3 then
+            Write("not three");
+        Write("done");
+    end.)";
+    expectSameBehaviour(source, "3");
+    expectSameBehaviour(source, "12");
+    expectSameBehaviour(source, "13");
+}
+
+TEST(BytecodeTest, read_truncates_integer_variables)
+{
+    string source = R"(
+    program Input;
+    var
+        i : integer;
+        d : double;
+    begin
+        Read(i);
+        Read(d);
+        Write(i, d, i + d);
+    end.)";
+    expectSameBehaviour(source, "2.75 2.75");
+    RunResult vm = runProgram<BytecodeExecutor>(source, "2.75 2.75");
+    EXPECT_EQ(vm.output, "Enter value for i: Enter value for d: 2 2.75 4.75\n");
+}
+
+TEST(BytecodeTest, runtime_errors_happen_at_same_point)
+{
+    // Деление на ноль после частичного вывода
+    expectSameBehaviour(R"(
+    program DivZero;
+    var
+        a : integer;
+    begin
+        Write("before");
+        a := 1 div a;
+        Write("after");
+    end.)");
+
+    // Присваивание константе и необъявленная переменная
+    expectSameBehaviour(R"(
+    program ConstAssign;
+    const
+        C = 1;
+    begin
+        Write("start");
+        C := 2;
+    end.)");
+    RunResult vm = runProgram<BytecodeExecutor>(R"(
+    program Undeclared;
+    begin
+        Write("start");
+        Write(y + 1);
+    end.)");
+    EXPECT_EQ(vm.output, "start\n");
+    EXPECT_EQ(vm.error, "Identifier 'y' isn't declared.");
+}
+
+TEST(BytecodeTest, errors_in_branches_that_do_not_run_are_ignored)
+{
+    RunResult vm = runProgram<BytecodeExecutor>(R"(
+    program Lazy;
+    var
+        a : integer;
+    begin
+        if a > 0 then
+            begin
+            Write(undefinedName);
+            end
+        else
+            Write("ok");
+    end.)");
+    EXPECT_EQ(vm.error, "");
+    EXPECT_EQ(vm.output, "ok\n");
+}
+
+TEST(BytecodeTest, declarations_errors_are_reported_at_compile_time)
+{
+    Lexer lexer;
+    vector<Lexeme> lexemes = lexer.Tokenize("program P; var x : integer; x : double; begin end.");
+    Parser parser;
+    HLNode* tree = parser.BuildHList(lexemes);
+
+    BytecodeCompiler compiler;
+    EXPECT_THROW(compiler.Compile(tree), runtime_error);
+
+    delete tree;
+}
+
+TEST(BytecodeTest, compiles_to_linear_code_with_resolved_jumps)
+{
+    Lexer lexer;
+    vector<Lexeme> lexemes = lexer.Tokenize(R"(
+    program Jumps;
+    const
+        Limit = 10;
+    var
+        a : integer;
+    begin
+        if a < Limit then
+            begin
+            a := a + 1;
+            end
+        else
+            a := 0;
+    end.)");
+    Parser parser;
+    HLNode* tree = parser.BuildHList(lexemes);
+
+    BytecodeCompiler compiler;
+    BytecodeProgram program = compiler.Compile(tree);
+
+    // Limit без типа - double: integer-операнд сравнения переводится в double,
+    // результат сравнения и арифметика над integer - команды integer
+    string expected =
+        "0: LOAD a\n"
+        "1: PUSH 10\n"
+        "2: TO_REAL_LHS\n"
+        "3: LT\n"
+        "4: JUMP_IF_FALSE_INT 10\n"
+        "5: LOAD a\n"
+        "6: PUSH_INT 1\n"
+        "7: ADD_INT\n"
+        "8: STORE_INT a\n"
+        "9: JUMP 12\n"
+        "10: PUSH_INT 0\n"
+        "11: STORE_INT a\n"
+        "12: HALT\n";
+    EXPECT_EQ(BytecodeToString(program), expected);
+    EXPECT_EQ(program.maxStack, 2u);
+
+    delete tree;
+}
+
+// integer-арифметика VM совпадает с обходом дерева: 64 бита с переполнением по модулю 2^64
+TEST(BytecodeTest, integer_overflow_matches_tree_walker)
+{
+    expectSameBehaviour(R"(
+    program Overflow;
+    const
+        Big : integer = 2147483647;
+    var
+        x, y, m, n : integer;
+        d : double;
+    begin
+        x := 2147483647;
+        m := 0 - 1;
+        n := 0 - 7;
+        Write(x * x * x, x * x, Big * Big * Big * Big, 9223372036854775807 + 1, x * x * x * x div 3);
+        Write(n div 2, n mod 2, n div m, n mod m, 7 div n, 7 mod n, x * x div m);
+        d := x * x * x;
+        Write(d, x * x * x + 0.5, x * x * x = 4611686014132420609, x * x < 0);
+    end.)");
+
+    RunResult vm = runProgram<BytecodeExecutor>("program P; var x : integer; begin x := 2147483647; Write(x * x * x); end.");
+    EXPECT_EQ(vm.output, "4.61169e+18\n");
+}
+
+// Присваивание integer-переменной усекает значение так же, как TableManager::writeSlot
+TEST(BytecodeTest, integer_truncation_matches_tree_walker)
+{
+    expectSameBehaviour(R"(
+    program Truncation;
+    const
+        Wide : integer = 3000000000;
+        Frac : integer = 7.9;
+    var
+        x, y, z : integer;
+        d : double;
+    begin
+        Read(x);
+        Read(d);
+        y := 3000000000;
+        z := 2147483647 + 1;
+        Write(x, d, y, z, Wide, Frac);
+        y := d * 3;
+        z := 9223372036854775807;
+        Write(y, z, 5000000000.75 + 0);
+        y := 5000000000.75;
+        Write(y);
+    end.)", "  -2.9\n 1.5e3 ");
+
+    RunResult vm = runProgram<BytecodeExecutor>("program P; var y : integer; begin y := 3000000000; Write(y); end.");
+    EXPECT_EQ(vm.output, "-1.29497e+09\n");
+}
@@ -0,0 +1,96 @@
+﻿#include "gtest.h"
+#include "flat_ast.h"
+#include "parser.h"
+#include "lexer.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    const string Source = R"(
+    program Flat;
+    const
+        Limit = 10;
+    var
+        a, b : integer;
+    begin
+        Read(a);
+        if a < Limit then
+            begin
+            b := a * 2;
+            if b > 5 then
+                Write("big", b);
+            end
+        else
+            b := 0;
+        Write(b);
+    end.)";
+
+    vector<Lexeme> tokenize(const string& source)
+    {
+        Lexer lexer;
+        return lexer.Tokenize(source);
+    }
+}
+
+TEST(FlatASTTest, parser_emits_same_tree_as_hlist)
+{
+    vector<Lexeme> input = tokenize(Source);
+    Parser parser;
+    HLNode* tree = parser.BuildHList(input);
+    FlatAST ast = parser.BuildFlat(input);
+
+    EXPECT_EQ(HLNodeToString(ast), HLNodeToString(tree, 0));
+    delete tree;
+}
+
+TEST(FlatASTTest, nodes_are_stored_in_depth_first_order)
+{
+    vector<Lexeme> input = tokenize(Source);
+    Parser parser;
+    FlatAST ast = parser.BuildFlat(input);
+
+    ASSERT_FALSE(ast.empty());
+    EXPECT_EQ(ast.kinds[0], NodeType::PROGRAM);
+    for (size_t i = 0; i < ast.size(); ++i) {
+        // Первый ребенок сразу за родителем, следующий узел уровня - после всей ветки
+        if (ast.firstChild[i] != FlatAST::None) {
+            EXPECT_EQ(ast.firstChild[i], static_cast<int>(i) + 1);
+        }
+        if (ast.nextSibling[i] != FlatAST::None) {
+            EXPECT_GT(ast.nextSibling[i], static_cast<int>(i));
+        }
+    }
+    // Выражения узлов лежат в общем массиве подряд
+    for (size_t i = 1; i < ast.size(); ++i)
+        EXPECT_EQ(ast.exprFirst[i], ast.exprLast[i - 1]);
+    EXPECT_EQ(ast.exprLast.back(), ast.tokens.size());
+}
+
+TEST(FlatASTTest, converts_to_and_from_hlnode)
+{
+    vector<Lexeme> input = tokenize(Source);
+    Parser parser;
+    HLNode* tree = parser.BuildHList(input);
+
+    FlatAST flat = FlattenHList(tree);
+    FlatAST direct = parser.BuildFlat(input);
+    EXPECT_EQ(flat.kinds, direct.kinds);
+    EXPECT_EQ(flat.firstChild, direct.firstChild);
+    EXPECT_EQ(flat.nextSibling, direct.nextSibling);
+    EXPECT_EQ(flat.tokens, direct.tokens);
+
+    HLNode* expanded = ExpandFlatAST(flat);
+    EXPECT_EQ(HLNodeToString(expanded, 0), HLNodeToString(tree, 0));
+
+    HLArena arena;
+    HLNode* inArena = ExpandFlatAST(flat, &arena);
+    EXPECT_EQ(HLNodeToString(inArena, 0), HLNodeToString(tree, 0));
+    EXPECT_EQ(arena.nodeCount(), flat.size());
+
+    delete expanded;
+    delete tree;
+}
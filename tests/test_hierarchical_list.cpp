@@ -1,5 +1,6 @@
 #include "gtest.h"
 #include "hierarchical_list.h"
+#include <string>
 
 TEST(HLNode, can_create_node_with_null_fields)
 {
@@ -40,3 +41,62 @@ TEST(HLNode, handles_null_lexeme_correctly)
 {
 
 }
+
+TEST(HLNode, appender_keeps_order_and_continues_existing_chain)
+{
+    HLNode parent(NodeType::MAIN_BLOCK, {});
+    HLNode* first = new HLNode(NodeType::STATEMENT, {});
+    parent.addChild(first);
+
+    HLNodeAppender children(&parent);
+    HLNode* ifNode = new HLNode(NodeType::IF, {});
+    HLNode* elseNode = new HLNode(NodeType::ELSE, {});
+    ifNode->pnext = elseNode;
+    children.append(ifNode);
+    HLNode* last = new HLNode(NodeType::STATEMENT, {});
+    children.append(last);
+    children.append(nullptr);
+
+    // Узел добавляется после всей цепочки pnext предыдущего (IF + ELSE)
+    EXPECT_EQ(parent.pdown, first);
+    EXPECT_EQ(first->pnext, ifNode);
+    EXPECT_EQ(ifNode->pnext, elseNode);
+    EXPECT_EQ(elseNode->pnext, last);
+    EXPECT_EQ(last->pnext, nullptr);
+}
+
+TEST(HLNode, deleting_very_long_chain_does_not_overflow_stack)
+{
+    // Рекурсивное удаление по pnext на такой цепочке переполнило бы стек
+    HLNode* head = new HLNode(NodeType::MAIN_BLOCK, {});
+    HLNodeAppender children(head);
+    HLNode* nested = nullptr;
+    for (int i = 0; i < 1000000; ++i) {
+        HLNode* node = new HLNode(NodeType::STATEMENT, {});
+        children.append(node);
+        if (i % 1000 == 0) {
+            nested = new HLNode(NodeType::IF, {});
+            node->pdown = nested;
+        }
+    }
+    EXPECT_NO_FATAL_FAILURE(delete head);
+}
+
+TEST(HLArena, places_nodes_in_blocks_and_frees_them_together)
+{
+    HLArena arena;
+    HLNode* root = arena.create(NodeType::PROGRAM);
+    HLNodeAppender children(root);
+    for (int i = 0; i < 3000; ++i)
+        children.append(arena.create(NodeType::STATEMENT, { { LexemeType::Number, to_string(i) } }));
+
+    EXPECT_EQ(arena.nodeCount(), 3001u);
+    // Узлы одного блока лежат подряд
+    EXPECT_EQ(root->pdown, root + 1);
+    EXPECT_EQ(root->pdown->pnext, root + 2);
+
+    int expected = 0;
+    for (HLNode* node = root->pdown; node; node = node->pnext, ++expected)
+        EXPECT_EQ(node->expr[0].value, to_string(expected));
+    EXPECT_EQ(expected, 3000);
+}
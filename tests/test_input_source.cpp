@@ -0,0 +1,163 @@
+﻿#include "gtest.h"
+#include "input_source.h"
+#include "program_executor.h"
+#include "bytecode.h"
+#include "parser.h"
+#include "lexer.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    vector<double> readAll(InputSource& source, size_t limit = 16)
+    {
+        vector<double> values;
+        double value;
+        while (values.size() < limit && source.next(value))
+            values.push_back(value);
+        return values;
+    }
+
+    // Терминал: запоминает, что уже было выведено к моменту каждого чтения
+    class ConsoleInputSource : public InputSource
+    {
+        const ostringstream& output;
+
+    public:
+        vector<string> shownBeforeRead;
+
+        explicit ConsoleInputSource(const ostringstream& output) : output(output) {}
+
+        bool next(double& value) override
+        {
+            shownBeforeRead.push_back(output.str());
+            value = 1.0;
+            return true;
+        }
+        bool interactive() const override { return true; }
+    };
+}
+
+TEST(InputSourceTest, parses_numbers_like_stream_extraction)
+{
+    double value = 0.0;
+    const string valid[] = { "3", "-2.75", "+4", "1e3", "0.5E-1", ".25" };
+    const double expected[] = { 3.0, -2.75, 4.0, 1000.0, 0.05, 0.25 };
+    for (size_t i = 0; i < 6; ++i) {
+        EXPECT_TRUE(ParseNumber(valid[i].data(), valid[i].data() + valid[i].size(), value)) << valid[i];
+        EXPECT_DOUBLE_EQ(value, expected[i]);
+    }
+    for (string invalid : { "", "+", "+-1", "abc", "3abc", "1.2.3", "inf", "nan", "1e400" })
+        EXPECT_FALSE(ParseNumber(invalid.data(), invalid.data() + invalid.size(), value)) << invalid;
+}
+
+TEST(InputSourceTest, buffer_and_stream_sources_agree)
+{
+    const string text = "  1 2.5\n-3\tbad word 7\n8 +9";
+    BufferInputSource buffer(text);
+    istringstream in(text);
+    StreamInputSource stream(in);
+
+    // Некорректное слово пропускается вместе с остатком строки
+    vector<double> first = { 1.0, 2.5, -3.0 };
+    EXPECT_EQ(readAll(buffer), first);
+    EXPECT_EQ(readAll(stream), first);
+    vector<double> rest = { 8.0, 9.0 };
+    EXPECT_EQ(readAll(buffer), rest);
+    EXPECT_EQ(readAll(stream), rest);
+
+    double value;
+    EXPECT_FALSE(buffer.next(value));
+    EXPECT_FALSE(stream.next(value));
+}
+
+TEST(InputSourceTest, array_source_returns_values_in_order)
+{
+    ArrayInputSource source({ 4.0, -1.5 });
+    EXPECT_EQ(readAll(source), vector<double>({ 4.0, -1.5 }));
+}
+
+TEST(InputSourceTest, executors_read_from_given_source_without_prompts)
+{
+    const string source = R"(
+    program Batch;
+    var
+        n : integer;
+        d : double;
+    begin
+        Read(n);
+        Read(d);
+        Write(n, d);
+    end.)";
+    Lexer lexer;
+    vector<Lexeme> lexemes = lexer.Tokenize(source);
+    Parser parser;
+
+    HLNode* tree = parser.BuildHList(lexemes);
+    ostringstream treeOut;
+    BufferInputSource treeInput("2.75 2.75");
+    ProgramExecutor executor(treeOut);
+    executor.setInput(treeInput);
+    executor.setPrompts(false);
+    executor.Execute(tree);
+    EXPECT_EQ(treeOut.str(), "2 2.75\n");
+    delete tree;
+
+    tree = parser.BuildHList(lexemes);
+    ostringstream vmOut;
+    ArrayInputSource vmInput({ 2.75, 2.75 });
+    BytecodeExecutor vm(vmOut);
+    vm.setInput(vmInput);
+    vm.setPrompts(false);
+    vm.Execute(tree);
+    EXPECT_EQ(vmOut.str(), treeOut.str());
+    delete tree;
+
+    // Ввод закончился раньше, чем Read
+    tree = parser.BuildHList(lexemes);
+    ArrayInputSource shortInput({ 1.0 });
+    ProgramExecutor failing(treeOut);
+    failing.setInput(shortInput);
+    EXPECT_THROW(failing.Execute(tree), runtime_error);
+    delete tree;
+}
+
+TEST(InputSourceTest, output_is_flushed_before_console_read_without_prompts)
+{
+    const string source = R"(
+    program Console;
+    var
+        n : integer;
+    begin
+        Write(7);
+        Read(n);
+        Write(n);
+    end.)";
+    Lexer lexer;
+    vector<Lexeme> lexemes = lexer.Tokenize(source);
+    Parser parser;
+
+    HLNode* tree = parser.BuildHList(lexemes);
+    ostringstream treeOut;
+    ConsoleInputSource treeInput(treeOut);
+    ProgramExecutor executor(treeOut);
+    executor.setInput(treeInput);
+    executor.setPrompts(false);
+    executor.Execute(tree);
+    EXPECT_EQ(treeInput.shownBeforeRead, vector<string>({ "7\n" }));
+    delete tree;
+
+    tree = parser.BuildHList(lexemes);
+    ostringstream vmOut;
+    ConsoleInputSource vmInput(vmOut);
+    BytecodeExecutor vm(vmOut);
+    vm.setInput(vmInput);
+    vm.setPrompts(false);
+    vm.Execute(tree);
+    EXPECT_EQ(vmInput.shownBeforeRead, treeInput.shownBeforeRead);
+    delete tree;
+}
@@ -0,0 +1,213 @@
+﻿#include "gtest.h"
+#include "jit.h"
+#include "postfix.h"
+#include "program_executor.h"
+#include "parser.h"
+#include "lexer.h"
+
+#include <climits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+    // Таблица с переменными разных типов для выражений тестов
+    void declareJitTestVariables(TableManager& tm)
+    {
+        tm.addInt("a", 17, false);
+        tm.addInt("b", -5, false);
+        tm.addInt("z", 0, false);
+        tm.addInt("m", -1, false);
+        tm.addInt("big", INT_MAX, false);
+        tm.addDouble("x", 2.5, false);
+        tm.addDouble("y", -0.75, false);
+        tm.addDouble("dz", 0.0, false);
+    }
+
+    CompiledExpr compileJitTestExpression(PostfixExecutor& executor, const string& text)
+    {
+        Lexer lexer;
+        vector<Lexeme> lexemes = lexer.Tokenize(text);
+        CompiledExpr compiled;
+        executor.compile(lexemes, 0, lexemes.size(), compiled);
+        return compiled;
+    }
+
+    string errorOf(PostfixExecutor& executor, const CompiledExpr& compiled)
+    {
+        try {
+            executor.executeTyped(compiled);
+        }
+        catch (const runtime_error& e) {
+            return e.what();
+        }
+        return "";
+    }
+}
+
+// Машинный код дает те же значения и типы, что и интерпретатор
+TEST(JitTest, native_code_matches_interpreter)
+{
+    const char* expressions[] = {
+        "1 + 2 * 3", "a - b * 4", "a * a * a * a * a * a * a * a * a * a * a * a * a * a * a * a",
+        "big * big * big", "a div 3", "b div 2", "a div b", "b div m", "a mod 3", "b mod 2", "a mod b", "b mod m",
+        "x + y", "x * a - b", "a / 4", "x / y", "x div y", "y div 0.5", "x mod y", "b mod x",
+        "a = 17", "a <> 17", "b < a", "a > b", "a <= 17", "b >= a", "x = 2.5", "x <> y", "y < x", "a > x",
+        "x <= 2.5", "y >= 0", "(a + b) * (x - y) / (a - b) + (a mod 4) * (b div 3)",
+        "a < b = 0", "5", "x",
+    };
+
+    TableManager tm;
+    declareJitTestVariables(tm);
+    PostfixExecutor interpreter(&tm);
+    PostfixExecutor jitted(&tm);
+    jitted.setJit(true, 0);
+    EXPECT_EQ(jitted.jitEnabled(), JitCompiler::available());
+
+    for (const char* text : expressions) {
+        CompiledExpr plain = compileJitTestExpression(interpreter, text);
+        CompiledExpr native = compileJitTestExpression(jitted, text);
+        EXPECT_EQ(plain.native, nullptr);
+        if (JitCompiler::available()) {
+            EXPECT_NE(native.native, nullptr) << text;
+        }
+
+        Value expected = interpreter.executeTyped(plain);
+        Value actual = jitted.executeTyped(native);
+        ASSERT_EQ(actual.type, expected.type) << text;
+        if (expected.isInteger())
+            EXPECT_EQ(actual.intValue, expected.intValue) << text;
+        else
+            EXPECT_DOUBLE_EQ(actual.doubleValue, expected.doubleValue) << text;
+    }
+}
+
+// Значения переменных читаются при каждом вызове, в том числе после роста таблицы символов
+TEST(JitTest, native_code_reads_current_variable_values)
+{
+    TableManager tm;
+    declareJitTestVariables(tm);
+    PostfixExecutor executor(&tm);
+    executor.setJit(true, 0);
+    CompiledExpr compiled = compileJitTestExpression(executor, "a * 2 + x");
+
+    EXPECT_DOUBLE_EQ(executor.executeTyped(compiled).doubleValue, 36.5);
+    tm.getInt("a") = -3;
+    tm.getDouble("x") = 0.25;
+    for (int i = 0; i < 100; ++i)
+        tm.addInt("extra" + to_string(i), i, false);
+    EXPECT_DOUBLE_EQ(executor.executeTyped(compiled).doubleValue, -5.75);
+}
+
+TEST(JitTest, division_by_zero_reports_interpreter_errors)
+{
+    TableManager tm;
+    declareJitTestVariables(tm);
+    PostfixExecutor interpreter(&tm);
+    PostfixExecutor jitted(&tm);
+    jitted.setJit(true, 0);
+
+    for (const char* text : { "a / z", "x / dz", "a div z", "x div dz", "a mod z", "x mod dz", "1 + a div z * 2" }) {
+        CompiledExpr plain = compileJitTestExpression(interpreter, text);
+        CompiledExpr native = compileJitTestExpression(jitted, text);
+        string expected = errorOf(interpreter, plain);
+        EXPECT_FALSE(expected.empty()) << text;
+        EXPECT_EQ(errorOf(jitted, native), expected) << text;
+    }
+}
+
+// Выражения, которые JIT не компилирует, вычисляются интерпретатором
+TEST(JitTest, unsupported_expressions_fall_back_to_interpreter)
+{
+    TableManager tm;
+    declareJitTestVariables(tm);
+    PostfixExecutor executor(&tm);
+    executor.setJit(true, 0);
+
+    CompiledExpr undeclared = compileJitTestExpression(executor, "a + missing");
+    EXPECT_EQ(undeclared.native, nullptr);
+    EXPECT_THROW(executor.executeTyped(undeclared), runtime_error);
+
+    CompiledExpr logical = compileJitTestExpression(executor, "a and b");
+    EXPECT_EQ(logical.native, nullptr);
+    EXPECT_THROW(executor.executeTyped(logical), runtime_error);
+
+    // После выключения JIT ранее скомпилированный код не вызывается
+    CompiledExpr sum = compileJitTestExpression(executor, "a + b");
+    executor.setJit(false);
+    EXPECT_FALSE(executor.jitEnabled());
+    EXPECT_EQ(executor.executeTyped(sum).intValue, 12);
+}
+
+// С порогом выражение сначала вычисляет интерпретатор, машинный код появляется на threshold-м вычислении
+TEST(JitTest, expressions_are_compiled_after_threshold_evaluations)
+{
+    TableManager tm;
+    declareJitTestVariables(tm);
+    PostfixExecutor executor(&tm);
+    executor.setJit(true, 3);
+    CompiledExpr compiled = compileJitTestExpression(executor, "a * x - b");
+
+    EXPECT_EQ(compiled.native, nullptr);
+    EXPECT_DOUBLE_EQ(executor.executeTyped(compiled).doubleValue, 47.5);
+    EXPECT_DOUBLE_EQ(executor.executeTyped(compiled).doubleValue, 47.5);
+    EXPECT_EQ(compiled.native, nullptr);
+    EXPECT_DOUBLE_EQ(executor.executeTyped(compiled).doubleValue, 47.5);
+    EXPECT_EQ(compiled.native != nullptr, JitCompiler::available());
+    EXPECT_DOUBLE_EQ(executor.executeTyped(compiled).doubleValue, 47.5);
+
+    // Повторная компиляция в тот же CompiledExpr сбрасывает машинный код и счетчик
+    Lexer lexer;
+    vector<Lexeme> lexemes = lexer.Tokenize("a - 1");
+    executor.compile(lexemes, 0, lexemes.size(), compiled);
+    EXPECT_EQ(compiled.native, nullptr);
+    EXPECT_EQ(executor.executeTyped(compiled).intValue, 16);
+}
+
+TEST(JitTest, program_output_is_the_same_with_jit)
+{
+    const string source = R"(
+    program Jit;
+    const
+        n = 10;
+    var
+        i, s : integer;
+        r : double;
+    begin
+        i := 0;
+        s := 0;
+        r := 1.5;
+        if (n mod 2 = 0) then
+        begin
+            s := n * (n + 1) div 2 - 7 mod 3;
+            r := r * s / 4 - (s div (0 - 4));
+        end
+        else
+            s := 0 - 1;
+        Write("s =", s, "r =", r, r > s, s mod 4);
+        Write(s div 0);
+    end.)";
+    Lexer lexer;
+    vector<Lexeme> lexemes = lexer.Tokenize(source);
+    Parser parser;
+
+    ostringstream plainOut;
+    HLNode* tree = parser.BuildHList(lexemes);
+    ProgramExecutor plain(plainOut);
+    EXPECT_THROW(plain.Execute(tree), runtime_error);
+    delete tree;
+
+    ostringstream jitOut;
+    tree = parser.BuildHList(lexemes);
+    ProgramExecutor jitted(jitOut);
+    jitted.setJit(true, 0);
+    EXPECT_THROW(jitted.Execute(tree), runtime_error);
+    delete tree;
+
+    EXPECT_EQ(jitOut.str(), plainOut.str());
+    EXPECT_NE(plainOut.str().find("s = 54"), string::npos);
+}
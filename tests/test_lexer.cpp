@@ -371,4 +371,103 @@ string expected = R"rr({Keyword : "program"}
     //cout << lexvectostr(res);
 
     EXPECT_EQ(lexvectostr(res), expected);
-}
\ No newline at end of file
+}
+
+TEST(Lexer, token_views_reference_source_and_intern_names) {
+    Lexer lexer;
+    NamePool pool;
+    std::string source = "Count := count + COUNT div 2; Write(\"Count\", total)";
+    std::vector<Token> tokens = lexer.TokenizeViews(source, pool);
+
+    // Текст токена - фрагмент исходной строки, без копирования
+    ASSERT_EQ(tokens.size(), 15u);
+    EXPECT_EQ(tokens[0].text, "Count");
+    EXPECT_EQ(tokens[0].text.data(), source.data());
+    EXPECT_EQ(tokens[10].type, LexemeType::StringLiteral);
+    EXPECT_EQ(tokens[10].text.data(), source.data() + source.find("Count\""));
+
+    // Одно имя в разных регистрах интернируется один раз
+    EXPECT_EQ(tokens[0].name, tokens[2].name);
+    EXPECT_EQ(tokens[0].name, tokens[4].name);
+    EXPECT_EQ(pool.name(tokens[0].name), "count");
+    EXPECT_EQ(tokens[10].name, -1);
+    EXPECT_EQ(pool.size(), 4u); // count, div, write, total
+}
+
+TEST(Lexer, token_views_convert_to_same_lexemes) {
+    Lexer lexer;
+    NamePool pool;
+    std::string source = "program P; VAR x : Integer; begin x := (x + 1.5) <> 2; write(\"a b\", x) end. ?";
+    std::vector<Token> tokens = lexer.TokenizeViews(source, pool);
+
+    std::vector<Lexeme> converted;
+    for (const Token& token : tokens)
+        converted.push_back(ToLexeme(token, pool));
+    EXPECT_EQ(lexvectostr(converted), lexvectostr(lexer.Tokenize(source)));
+}
+
+TEST(Lexer, splits_adjacent_operators_without_spaces) {
+    Lexer lexer;
+    std::string source = "a:=b<>c<=d>=e:f<g>h=:<<>";
+    std::vector<Lexeme> expected = {
+        { LexemeType::Identifier, "a" }, { LexemeType::Operator, ":=" },
+        { LexemeType::Identifier, "b" }, { LexemeType::Operator, "<>" },
+        { LexemeType::Identifier, "c" }, { LexemeType::Operator, "<=" },
+        { LexemeType::Identifier, "d" }, { LexemeType::Operator, ">=" },
+        { LexemeType::Identifier, "e" }, { LexemeType::Separator, ":" },
+        { LexemeType::Identifier, "f" }, { LexemeType::Operator, "<" },
+        { LexemeType::Identifier, "g" }, { LexemeType::Operator, ">" },
+        { LexemeType::Identifier, "h" }, { LexemeType::Operator, "=" },
+        { LexemeType::Separator, ":" }, { LexemeType::Operator, "<" },
+        { LexemeType::Operator, "<>" },
+        { LexemeType::EndOfFile, "" }
+    };
+    EXPECT_EQ(lexer.Tokenize(source), expected);
+}
+
+TEST(Lexer, lexeme_stream_yields_same_lexemes_on_demand) {
+    Lexer lexer;
+    std::string source = "begin X := 1.5 + y; write(\"s\") end.";
+    std::vector<Lexeme> expected = lexer.Tokenize(source);
+
+    LexemeStream stream(source);
+    std::vector<Lexeme> pulled;
+    Lexeme lex;
+    while (stream.next(lex))
+        pulled.push_back(lex);
+    EXPECT_EQ(lexvectostr(pulled), lexvectostr(expected));
+    EXPECT_FALSE(stream.next(lex)); // После EndOfFile лексем больше нет
+}
+
+TEST(Lexer, numbers_carry_parsed_values) {
+    Lexer lexer;
+    std::vector<Lexeme> lexemes = lexer.Tokenize("x := 42 + 2.5 - 99999999999999999999 * 7.;");
+    ASSERT_EQ(lexemes.size(), 11u);
+
+    EXPECT_EQ(lexemes[2].number.type, ValueType::Integer);
+    EXPECT_EQ(lexemes[2].number.intValue, 42);
+    EXPECT_EQ(lexemes[4].number.type, ValueType::Double);
+    EXPECT_DOUBLE_EQ(lexemes[4].number.doubleValue, 2.5);
+    // Целое, которое не помещается в 64 бита, становится double
+    EXPECT_EQ(lexemes[6].number.type, ValueType::Double);
+    EXPECT_DOUBLE_EQ(lexemes[6].number.doubleValue, 1e20);
+    EXPECT_EQ(lexemes[8].number.type, ValueType::Double);
+    EXPECT_DOUBLE_EQ(lexemes[8].number.doubleValue, 7.0);
+    // Не числа значения не имеют
+    EXPECT_EQ(lexemes[0].number.type, ValueType::Unknown);
+
+    // Лексема, созданная не лексером, разбирается из текста
+    EXPECT_EQ(NumberValue({ LexemeType::Number, "-3" }).intValue, -3);
+    EXPECT_THROW(NumberValue({ LexemeType::Number, "1.2.3" }), std::runtime_error);
+}
+
+TEST(Lexer, rejects_malformed_numbers) {
+    Lexer lexer;
+    EXPECT_THROW(lexer.Tokenize("x := 1.2.3;"), std::runtime_error);
+    EXPECT_THROW(lexer.Tokenize("x := 1..2;"), std::runtime_error);
+
+    LexemeStream stream("a 2.0.1");
+    Lexeme lex;
+    EXPECT_TRUE(stream.next(lex));
+    EXPECT_THROW(stream.next(lex), std::runtime_error);
+}
@@ -3,6 +3,9 @@
 int main(int argc, char **argv)
 {
 	::testing::InitGoogleTest(&argc, argv);
-	RUN_ALL_TESTS();
+	int result = RUN_ALL_TESTS();
+#ifndef PASCAL_NO_PAUSE
 	system("pause");
+#endif
+	return result;
 }
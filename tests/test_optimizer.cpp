@@ -0,0 +1,159 @@
+﻿#include "gtest.h"
+#include "optimizer.h"
+#include "program_executor.h"
+#include "parser.h"
+#include "lexer.h"
+
+#include <sstream>
+#include <string>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    HLNode* parseProgram(const string& source)
+    {
+        Lexer lexer;
+        vector<Lexeme> lexemes = lexer.Tokenize(source);
+        Parser parser;
+        return parser.BuildHList(lexemes);
+    }
+
+    // Вывод и текст ошибки ProgramExecutor (с предварительной сверткой констант или без нее)
+    string runOptimized(const string& source, bool optimize, const string& input = "")
+    {
+        HLNode* tree = parseProgram(source);
+        if (optimize) {
+            ConstantFolder folder;
+            folder.Optimize(tree);
+        }
+
+        stringstream in(input), out;
+        streambuf* old_cin = cin.rdbuf(in.rdbuf());
+        streambuf* old_cout = cout.rdbuf(out.rdbuf());
+        try {
+            ProgramExecutor executor;
+            executor.Execute(tree);
+        }
+        catch (const runtime_error& e) {
+            out << "error: " << e.what();
+        }
+        cin.rdbuf(old_cin);
+        cout.rdbuf(old_cout);
+        delete tree;
+        return out.str();
+    }
+
+    void expectSameAsUnoptimized(const string& source, const string& input = "")
+    {
+        EXPECT_EQ(runOptimized(source, true, input), runOptimized(source, false, input));
+    }
+}
+
+TEST(ConstantFolderTest, folds_constants_into_literals)
+{
+    HLNode* tree = parseProgram(R"(
+    program Fold;
+    const
+        K : integer = 2;
+        Pi = 3.5;
+    var
+        x : integer;
+    begin
+        x := K * 3 + x;
+        Write(Pi * 2, x - K * 3);
+        if x > K * K then
+            Write("big");
+    end.)");
+
+    ConstantFolder folder;
+    EXPECT_EQ(folder.Optimize(tree), 4u);
+
+    string dump = HLNodeToString(tree, 0);
+    EXPECT_NE(dump.find("x := 6 + x ]"), string::npos) << dump;
+    EXPECT_NE(dump.find("7.0"), string::npos) << dump;
+    EXPECT_NE(dump.find("x - 6 ]"), string::npos) << dump;
+    EXPECT_NE(dump.find("x > 4"), string::npos) << dump;
+    delete tree;
+}
+
+TEST(ConstantFolderTest, keeps_parentheses_that_change_the_result)
+{
+    HLNode* tree = parseProgram(R"(
+    program Parens;
+    const
+        K = 2;      // Константа без типа - double
+    var
+        x, y : integer;
+    begin
+        y := x - (y - K * 1);
+        y := (x + K) * y;
+    end.)");
+
+    ConstantFolder folder;
+    folder.Optimize(tree);
+
+    string dump = HLNodeToString(tree, 0);
+    EXPECT_NE(dump.find("y := x - ( y - 2.0 ) ]"), string::npos) << dump;
+    EXPECT_NE(dump.find("y := ( x + 2.0 ) * y ]"), string::npos) << dump;
+    delete tree;
+}
+
+TEST(ConstantFolderTest, folded_program_behaves_like_original)
+{
+    expectSameAsUnoptimized(R"(
+    program Same;
+    const
+        A = 7;
+        B = A div 2 - 5;
+        Half : double = 1 / 2;
+    var
+        n : integer;
+        d : double;
+    begin
+        Read(n);
+        d := n / (A - B) + Half * 3;
+        n := n mod A + B * (A - 1) div 4;
+        Write(n, d, A / 3, B mod 2, -7 div 2);
+        if n + B * 0 <> A then
+            begin
+            Write("branch", n * (A + 1));
+            end
+        else
+            Write("other");
+    end.)", "10");
+}
+
+TEST(ConstantFolderTest, runtime_errors_are_not_folded_away)
+{
+    // Деление на ноль из одних констант остается в выражении
+    string source = R"(
+    program DivZero;
+    const
+        Zero = 0;
+    var
+        a : integer;
+    begin
+        Write("before");
+        a := 1 div Zero;
+        Write("after");
+    end.)";
+    expectSameAsUnoptimized(source);
+    EXPECT_NE(runOptimized(source, true).find("error: "), string::npos);
+
+    // Присваивание константе по-прежнему ошибка
+    expectSameAsUnoptimized(R"(
+    program ConstAssign;
+    const
+        C = 1;
+    begin
+        C := C + 1;
+    end.)");
+
+    // Некорректные объявления: дерево не изменяется
+    HLNode* tree = parseProgram("program P; const C = 1; C = 2; begin Write(C + 1); end.");
+    ConstantFolder folder;
+    EXPECT_EQ(folder.Optimize(tree), 0u);
+    delete tree;
+}
@@ -0,0 +1,88 @@
+﻿#include "gtest.h"
+#include "output_sink.h"
+#include "program_executor.h"
+#include "bytecode.h"
+#include "parser.h"
+#include "lexer.h"
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+// Формат числа совпадает с operator<< потока по умолчанию
+TEST(OutputSinkTest, formats_numbers_like_ostream)
+{
+    const double values[] = {
+        0.0, -0.0, 1.0, -1.0, 42.0, 999999.0, 1000000.0, -1234567.0, 1e15, 1e300,
+        0.5, 0.25, 3.1415926, -2.75, 1.0 / 3.0, 123456.5, 0.0001, 0.00001234, 1e-300,
+        numeric_limits<double>::infinity(), -numeric_limits<double>::infinity()
+    };
+    for (double value : values) {
+        ostringstream expected;
+        expected << value;
+        char text[32];
+        EXPECT_EQ(string(text, FormatNumber(value, text, text + sizeof(text))), expected.str()) << value;
+    }
+}
+
+TEST(OutputSinkTest, keeps_text_until_flush_or_full_buffer)
+{
+    ostringstream out;
+    OutputSink sink(out, 8);
+    sink.write("abc");
+    sink.write(' ');
+    EXPECT_EQ(out.str(), "");
+
+    sink.writeNumber(2.5);
+    EXPECT_EQ(out.str(), "");
+    sink.write("\n");
+    EXPECT_EQ(out.str(), "abc 2.5\n");    // Буфер заполнен - сброшен целиком
+
+    sink.write("tail");
+    sink.flush();
+    EXPECT_EQ(out.str(), "abc 2.5\ntail");
+}
+
+TEST(OutputSinkTest, flushes_on_destruction)
+{
+    ostringstream out;
+    {
+        OutputSink sink(out);
+        sink.write("done");
+        EXPECT_EQ(out.str(), "");
+    }
+    EXPECT_EQ(out.str(), "done");
+}
+
+// Исполнители пишут в переданный поток, вывод до ошибки выполнения не теряется
+TEST(OutputSinkTest, executors_write_to_given_stream)
+{
+    const string source = R"(
+    program Out;
+    var
+        a : integer;
+    begin
+        Write("a =", a + 1, 0.5);
+        Write(1 div a);
+    end.)";
+    Lexer lexer;
+    vector<Lexeme> lexemes = lexer.Tokenize(source);
+
+    Parser parser;
+    HLNode* tree = parser.BuildHList(lexemes);
+    ostringstream treeOut;
+    ProgramExecutor executor(treeOut);
+    EXPECT_THROW(executor.Execute(tree), runtime_error);
+    EXPECT_EQ(treeOut.str(), "a = 1 0.5\n");
+    delete tree;
+
+    tree = parser.BuildHList(lexemes);
+    ostringstream vmOut;
+    BytecodeExecutor vm(vmOut);
+    EXPECT_THROW(vm.Execute(tree), runtime_error);
+    EXPECT_EQ(vmOut.str(), treeOut.str());
+    delete tree;
+}
@@ -159,4 +159,75 @@ TEST(ParserTest, FullProgram) {
     cout << res << endl;
     cout << "!\n" << endl;*/
     EXPECT_EQ(res, expected);
-}
\ No newline at end of file
+}
+
+// Порядок узлов в длинном блоке и привязка ELSE сохраняются при добавлении в конец
+TEST(ParserTest, keeps_statement_order_in_long_block) {
+    string source = "program Long; var x; begin ";
+    for (int i = 0; i < 1000; ++i)
+        source += "x := " + to_string(i) + "; ";
+    source += "if x > 1 then begin x := 1; end else x := 2; Write(x); end.";
+    Lexer lexer;
+    vector<Lexeme> input = lexer.Tokenize(source);
+    Parser parser;
+    HLNode* root = parser.BuildHList(input);
+
+    HLNode* node = root->pdown->pnext->pdown; // VAR_SECTION -> MAIN_BLOCK -> первый оператор
+    for (int i = 0; i < 1000; ++i, node = node->pnext) {
+        ASSERT_NE(node, nullptr);
+        EXPECT_EQ(node->expr[2].value, to_string(i));
+    }
+    ASSERT_NE(node, nullptr);
+    EXPECT_EQ(node->type, NodeType::IF);
+    EXPECT_EQ(node->pnext->type, NodeType::ELSE);
+    EXPECT_EQ(node->pnext->pnext->type, NodeType::CALL);
+    EXPECT_EQ(node->pnext->pnext->pnext, nullptr);
+    delete root;
+}
+
+// Дерево в регионе совпадает с деревом из отдельно выделенных узлов
+TEST(ParserTest, builds_same_tree_in_arena) {
+    string source =
+        "program Test; const c = 2; var x : integer;"
+        "begin if x < c then begin x := x + 1; end else Write(x); Read(x); end.";
+    Lexer lexer;
+    vector<Lexeme> input = lexer.Tokenize(source);
+
+    Parser heapParser;
+    HLNode* heapTree = heapParser.BuildHList(input);
+    HLArena arena;
+    Parser arenaParser;
+    HLNode* arenaTree = arenaParser.BuildHList(input, arena);
+
+    EXPECT_EQ(HLNodeToString(arenaTree, 0), HLNodeToString(heapTree, 0));
+    EXPECT_EQ(arena.nodeCount(), 13u);
+    delete heapTree;
+}
+
+// Разбор из потока лексем дает то же дерево, что и разбор готового списка
+TEST(ParserTest, parses_lexeme_stream_without_token_vector) {
+    string source =
+        "program Test; const c = 2; var x : integer;"
+        "begin Read(x); if x < c then begin x := x + 1; end else Write(\"small\", x); end.";
+    Lexer lexer;
+    vector<Lexeme> input = lexer.Tokenize(source);
+    Parser parser;
+    HLNode* fromVector = parser.BuildHList(input);
+
+    LexemeStream stream(source);
+    HLNode* fromStream = parser.BuildHList(stream);
+    EXPECT_EQ(HLNodeToString(fromStream, 0), HLNodeToString(fromVector, 0));
+
+    LexemeStream flatStream(source);
+    EXPECT_EQ(HLNodeToString(parser.BuildFlat(flatStream)), HLNodeToString(fromVector, 0));
+
+    delete fromStream;
+    delete fromVector;
+}
+
+// Незакрытый список аргументов в конце текста - ошибка, а не бесконечный цикл
+TEST(ParserTest, throws_when_arguments_reach_end_of_input) {
+    LexemeStream stream("program Test; begin write(x, y");
+    Parser parser;
+    EXPECT_THROW(parser.BuildHList(stream), runtime_error);
+}
@@ -221,3 +221,119 @@ TEST(PostfixExecutorTest, HandlesUndeclaredIdentifierInExpression) {
     delete tempNode;
 }
 
+
+//  :       
+Value evaluateTypedForPostfixTest(PostfixExecutor& executor, const vector<Lexeme>& infix) {
+    CompiledExpr compiled;
+    executor.compile(infix, 0, infix.size(), compiled);
+    return executor.executeTyped(compiled);
+}
+
+TEST(PostfixExecutorTest, IntegerExpressionsAreExactAndKeepType) {
+    TableManager tm;
+    PostfixExecutor executor(&tm);
+    tm.addInt("x", 123456789, false);
+    tm.addDouble("d", 2.0, false);
+
+    // x * 1000000007 mod 998244353:    2^53
+    Value product = evaluateTypedForPostfixTest(executor, {
+        {LexemeType::Identifier, "x"}, {LexemeType::Operator, "*"}, {LexemeType::Number, "1000000007"},
+        {LexemeType::Operator, "mod"}, {LexemeType::Number, "998244353"} });
+    ASSERT_TRUE(product.isInteger());
+    EXPECT_EQ(product.intValue, 605556822);
+
+    //     '/'  double
+    Value mixed = evaluateTypedForPostfixTest(executor, {
+        {LexemeType::Identifier, "x"}, {LexemeType::Operator, "+"}, {LexemeType::Identifier, "d"} });
+    EXPECT_FALSE(mixed.isInteger());
+    EXPECT_DOUBLE_EQ(mixed.doubleValue, 123456791.0);
+
+    Value division = evaluateTypedForPostfixTest(executor, {
+        {LexemeType::Number, "7"}, {LexemeType::Operator, "/"}, {LexemeType::Number, "2"} });
+    EXPECT_FALSE(division.isInteger());
+    EXPECT_DOUBLE_EQ(division.doubleValue, 3.5);
+
+    //    integer 0/1
+    Value comparison = evaluateTypedForPostfixTest(executor, {
+        {LexemeType::Identifier, "x"}, {LexemeType::Operator, ">"}, {LexemeType::Number, "5"} });
+    ASSERT_TRUE(comparison.isInteger());
+    EXPECT_EQ(comparison.intValue, 1);
+}
+
+TEST(PostfixExecutorTest, IntegerDivAndModMatchDoublePath) {
+    TableManager tm;
+    PostfixExecutor executor(&tm);
+    tm.addInt("n", -7, false);
+    tm.addDouble("nd", -7.0, false);
+
+    for (const char* op : { "div", "mod" }) {
+        Value asInt = evaluateTypedForPostfixTest(executor, {
+            {LexemeType::Identifier, "n"}, {LexemeType::Operator, op}, {LexemeType::Number, "2"} });
+        Value asDouble = evaluateTypedForPostfixTest(executor, {
+            {LexemeType::Identifier, "nd"}, {LexemeType::Operator, op}, {LexemeType::Number, "2"} });
+        ASSERT_TRUE(asInt.isInteger());
+        ASSERT_FALSE(asDouble.isInteger());
+        EXPECT_DOUBLE_EQ(asInt.asDouble(), asDouble.doubleValue) << op;
+    }
+
+    EXPECT_THROW(evaluateTypedForPostfixTest(executor, {
+        {LexemeType::Identifier, "n"}, {LexemeType::Operator, "div"}, {LexemeType::Number, "0"} }), std::runtime_error);
+}
+
+TEST(PostfixExecutorTest, OperatorTableDrivesPrecedenceAndDispatch) {
+    TableManager tm;
+    PostfixExecutor executor(&tm);
+
+    EXPECT_EQ(ClassifyOperator("div"), OperatorKind::IntDiv);
+    EXPECT_EQ(ClassifyOperator("<>"), OperatorKind::Ne);
+    EXPECT_EQ(ClassifyOperator("**"), OperatorKind::None);
+    EXPECT_GT(PostfixExecutor::precedence("mod"), PostfixExecutor::precedence("-"));
+    EXPECT_EQ(PostfixExecutor::precedence("**"), -1);
+
+    // 10 - 2 * 3 mod 4 = 8:   mod  ,  -  
+    // (      (10 - 2) * 3 mod 4 = 0)
+    Value result = evaluateTypedForPostfixTest(executor, {
+        {LexemeType::Number, "10"}, {LexemeType::Operator, "-"}, {LexemeType::Number, "2"},
+        {LexemeType::Operator, "*"}, {LexemeType::Number, "3"}, {LexemeType::Operator, "mod"},
+        {LexemeType::Number, "4"}, {LexemeType::Operator, "="}, {LexemeType::Number, "8"} });
+    ASSERT_TRUE(result.isInteger());
+    EXPECT_EQ(result.intValue, 1);
+
+    //    (    )
+    EXPECT_THROW(evaluateTypedForPostfixTest(executor, {
+        {LexemeType::Number, "1"}, {LexemeType::Operator, "and"}, {LexemeType::Number, "0"} }), std::runtime_error);
+}
+
+TEST(PostfixExecutorTest, CompileRecordsStackDepthAndBalance) {
+    TableManager tm;
+    PostfixExecutor executor(&tm);
+
+    // 1 + 2 * (3 - 4): rpn 1 2 3 4 - * +,    4
+    vector<Lexeme> deep = {
+        {LexemeType::Number, "1"}, {LexemeType::Operator, "+"}, {LexemeType::Number, "2"},
+        {LexemeType::Operator, "*"}, {LexemeType::Separator, "("}, {LexemeType::Number, "3"},
+        {LexemeType::Operator, "-"}, {LexemeType::Number, "4"}, {LexemeType::Separator, ")"} };
+    CompiledExpr deepExpr;
+    executor.compile(deep, 0, deep.size(), deepExpr);
+    EXPECT_TRUE(deepExpr.balanced);
+    EXPECT_EQ(deepExpr.maxDepth, 4u);
+
+    vector<Lexeme> flat = { {LexemeType::Number, "5"}, {LexemeType::Operator, "*"}, {LexemeType::Number, "6"} };
+    CompiledExpr flatExpr;
+    executor.compile(flat, 0, flat.size(), flatExpr);
+    EXPECT_TRUE(flatExpr.balanced);
+    EXPECT_EQ(flatExpr.maxDepth, 2u);
+
+    //   :         
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(executor.executeTyped(flatExpr).intValue, 30);
+        EXPECT_EQ(executor.executeTyped(deepExpr).intValue, -1);
+    }
+
+    //    :        
+    vector<Lexeme> broken = { {LexemeType::Operator, "*"}, {LexemeType::Number, "6"} };
+    CompiledExpr brokenExpr;
+    executor.compile(broken, 0, broken.size(), brokenExpr);
+    EXPECT_FALSE(brokenExpr.balanced);
+    EXPECT_THROW(executor.executeTyped(brokenExpr), std::runtime_error);
+}
@@ -978,6 +978,84 @@ TEST(ProgramExecutorTest, CanUseConstantInExpression) {
     deleteHLNode(program);
 }
 
+TEST(ProgramExecutorTest, CachesCompiledExpressionInNode) {
+    ProgramExecutor executor;
+    // var a; begin a := 2 + 3; write(a * 2); end.
+    auto varDecl = createDeclarationNode({ {LexemeType::Identifier, "a"}, {LexemeType::Separator, ";"} });
+    auto varSection = createSectionNode(NodeType::VAR_SECTION, { varDecl });
+
+    auto assign = createStatementNode({
+        {LexemeType::Identifier, "a"}, {LexemeType::Operator, ":="},
+        {LexemeType::Number, "2"}, {LexemeType::Operator, "+"}, {LexemeType::Number, "3"},
+        {LexemeType::Separator, ";"}
+        });
+    auto writeArg = createStatementNode({ {LexemeType::Identifier, "a"}, {LexemeType::Operator, "*"}, {LexemeType::Number, "2"} });
+    auto writeCall = createCallNode({ LexemeType::Keyword, "write" }, { writeArg });
+    auto mainBlock = createMainBlockNode({ assign, writeCall });
+    varSection->pnext = mainBlock;
+    auto program = createProgramNode(varSection);
+
+    // До выполнения постфиксная запись не строится
+    EXPECT_EQ(assign->compiled, nullptr);
+
+    std::stringstream output;
+    std::streambuf* old_cout = std::cout.rdbuf(output.rdbuf());
+    ASSERT_NO_THROW(executor.Execute(program));
+    std::cout.rdbuf(old_cout);
+
+    EXPECT_EQ(output.str(), "10\n");
+
+    // Правая часть присваивания закэширована без "a :=" и ';': 2 3 +
+    ASSERT_NE(assign->compiled, nullptr);
+    vector<Lexeme> expected = { {LexemeType::Number, "2"}, {LexemeType::Number, "3"}, {LexemeType::Operator, "+"} };
+    EXPECT_EQ(assign->compiled->rpn, expected);
+    ASSERT_NE(writeArg->compiled, nullptr);
+    EXPECT_EQ(writeArg->compiled->rpn.size(), 3u);
+
+    deleteHLNode(program);
+}
+
+TEST(ProgramExecutorTest, ResolvesIdentifiersToSlotsBeforeExecution) {
+    ProgramExecutor executor;
+    // const k = 2; var a, b; begin a := k; b := a + k; write(b); end.
+    auto constDecl = createDeclarationNode({ {LexemeType::Identifier, "k"}, {LexemeType::Operator, "="}, {LexemeType::Number, "2"}, {LexemeType::Separator, ";"} });
+    auto constSection = createSectionNode(NodeType::CONST_SECTION, { constDecl });
+    auto varDecl = createDeclarationNode({ {LexemeType::Identifier, "a"}, {LexemeType::Separator, ","}, {LexemeType::Identifier, "b"}, {LexemeType::Separator, ";"} });
+    auto varSection = createSectionNode(NodeType::VAR_SECTION, { varDecl });
+
+    auto assignA = createStatementNode({ {LexemeType::Identifier, "a"}, {LexemeType::Operator, ":="}, {LexemeType::Identifier, "k"}, {LexemeType::Separator, ";"} });
+    auto assignB = createStatementNode({
+        {LexemeType::Identifier, "b"}, {LexemeType::Operator, ":="},
+        {LexemeType::Identifier, "a"}, {LexemeType::Operator, "+"}, {LexemeType::Identifier, "k"},
+        {LexemeType::Separator, ";"}
+        });
+    auto writeArg = createStatementNode({ {LexemeType::Identifier, "b"} });
+    auto writeCall = createCallNode({ LexemeType::Keyword, "write" }, { writeArg });
+    auto mainBlock = createMainBlockNode({ assignA, assignB, writeCall });
+    constSection->pnext = varSection;
+    varSection->pnext = mainBlock;
+    auto program = createProgramNode(constSection);
+
+    std::stringstream output;
+    std::streambuf* old_cout = std::cout.rdbuf(output.rdbuf());
+    ASSERT_NO_THROW(executor.Execute(program));
+    std::cout.rdbuf(old_cout);
+
+    EXPECT_EQ(output.str(), "4\n");
+
+    // Слоты выдаются в порядке объявления: k - 0, a - 1, b - 2
+    EXPECT_EQ(assignA->expr[0].slot, 1);
+    EXPECT_EQ(assignA->expr[2].slot, 0);
+    EXPECT_EQ(assignB->expr[0].slot, 2);
+    EXPECT_EQ(assignB->expr[2].slot, 1);
+    EXPECT_EQ(writeArg->expr[0].slot, 2);
+    // Разрешенные слоты попадают и в закэшированную постфиксную запись
+    ASSERT_NE(assignB->compiled, nullptr);
+    EXPECT_EQ(assignB->compiled->rpn[0].slot, 1);
+
+    deleteHLNode(program);
+}
+
 
 TEST(ExecutorTest, FullProgram) {
     string source = //Íå ðàáîòàåò â îáúÿâëåíèÿõ ïðèñâîåíèå ñ óêàçàíèåì òèïà, îáúÿâëåíèå íåñêîëüêèõ ïåðåìåííûõ, ïîõîæå òèï äàáë âîîáùå íåëüçÿ îþúÿâèòü
@@ -1015,6 +1093,10 @@ TEST(ExecutorTest, FullProgram) {
 
     ProgramExecutor executor;
 
+    // Ввод подставляется, чтобы тест не ждал консоль (в том числе под ctest)
+    stringstream in("3 4"), out;
+    streambuf* old_cin = cin.rdbuf(in.rdbuf());
+    streambuf* old_cout = cout.rdbuf(out.rdbuf());
 
     EXPECT_NO_THROW(
         try {
@@ -1025,4 +1107,8 @@ TEST(ExecutorTest, FullProgram) {
         cout << "!!!! ERROR\n" << e.what() << endl;
     }
         );
+
+    cin.rdbuf(old_cin);
+    cout.rdbuf(old_cout);
+    EXPECT_EQ(out.str(), "Input int: \nEnter value for num2: Input double divisible by two: \nEnter value for d: Result =  4\n");
 }
\ No newline at end of file
@@ -0,0 +1,56 @@
+﻿#include "gtest.h"
+#include "source_file.h"
+#include "lexer.h"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace
+{
+    // Временный файл в текущем каталоге, удаляется в деструкторе
+    struct TempFile
+    {
+        string path;
+
+        TempFile(const string& name, const string& content) : path(name)
+        {
+            ofstream out(path, ios::binary);
+            out << content;
+        }
+
+        ~TempFile() { remove(path.c_str()); }
+    };
+}
+
+TEST(SourceFileTest, loads_whole_file_as_view)
+{
+    string content = "program P;\nbegin\n    Write(\"ok\");\nend.\n";
+    TempFile file("source_file_test_prog.tmp", content);
+
+    SourceFile source(file.path);
+    EXPECT_EQ(source.text(), content);
+#ifndef _WIN32
+    EXPECT_EQ(source.method(), SourceFile::LoadMethod::Mapped);
+#endif
+
+    Lexer lexer;
+    NamePool pool;
+    vector<Token> tokens = lexer.TokenizeViews(source.text(), pool);
+    EXPECT_EQ(tokens[0].text.data(), source.text().data()); // Лексер работает прямо по отображению
+}
+
+TEST(SourceFileTest, empty_file_gives_empty_text)
+{
+    TempFile file("source_file_test_empty.tmp", "");
+    SourceFile source(file.path);
+    EXPECT_TRUE(source.text().empty());
+}
+
+TEST(SourceFileTest, throws_for_missing_file)
+{
+    EXPECT_THROW(SourceFile("no_such_dir/no_such_file.pas"), runtime_error);
+}
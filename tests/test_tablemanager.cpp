@@ -270,3 +270,230 @@ TEST(TableManagerTest, IsConstantThrowsForNonExistent) {
     TableManager manager;
     EXPECT_THROW(manager.isConstant("nonexistent_key"), std::out_of_range);
 }
+
+TEST(TableManagerTest, SlotsAreDenseAndSharedWithNamedAccess) {
+    TableManager manager;
+    manager.addInt("i", 7, false);
+    manager.addDouble("d", 1.5, false);
+    manager.addInt("c", 3, true);
+
+    EXPECT_EQ(manager.slotCount(), 3u);
+    EXPECT_EQ(manager.findSlot("i"), 0);
+    EXPECT_EQ(manager.findSlot("d"), 1);
+    EXPECT_EQ(manager.findSlot("c"), 2);
+    EXPECT_EQ(manager.findSlot("missing"), -1);
+
+    EXPECT_TRUE(manager.symbol(0).isInteger);
+    EXPECT_FALSE(manager.symbol(1).isInteger);
+    EXPECT_TRUE(manager.symbol(2).isConstant);
+
+    //      , integer 
+    manager.writeSlot(0, 9.75);
+    EXPECT_EQ(manager.getInt("i"), 9);
+    manager.getDouble("d") = 2.25;
+    EXPECT_DOUBLE_EQ(manager.readSlot(1), 2.25);
+    EXPECT_DOUBLE_EQ(manager.readSlot(2), 3.0);
+}
+
+TEST(TableManagerTest, LookupDoesNotThrowForMissingNames) {
+    TableManager manager;
+    manager.addInt("count", 4, false);
+    manager.addDouble("Pi", 3.14, true);
+
+    EXPECT_NO_THROW(manager.lookup("missing"));
+    EXPECT_EQ(manager.lookup("missing"), nullptr);
+
+    const Symbol* count = manager.lookup("count");
+    ASSERT_NE(count, nullptr);
+    EXPECT_TRUE(count->isInteger);
+    EXPECT_FALSE(count->isConstant);
+    EXPECT_DOUBLE_EQ(count->value(), 4.0);
+
+    const Symbol* pi = manager.lookup("Pi");
+    ASSERT_NE(pi, nullptr);
+    EXPECT_FALSE(pi->isInteger);
+    EXPECT_TRUE(pi->isConstant);
+    EXPECT_DOUBLE_EQ(pi->value(), 3.14);
+
+    //       
+    manager.lookup("count")->intValue = 5;
+    EXPECT_EQ(manager.getIntConst("count"), 5);
+}
+
+// --- Google Tests  THashTableOpen ---
+
+TEST(THashTableOpenTest, can_insert_find_and_check_constant) {
+    THashTableOpen<std::string, int> table;
+    EXPECT_TRUE(table.Insert("var1", 10, false));
+    EXPECT_TRUE(table.Insert("const1", 20, true));
+    EXPECT_FALSE(table.Insert("var1", 99, true)); //    
+
+    EXPECT_EQ(2, table.size());
+    EXPECT_EQ(10, *table.Find("var1"));
+    EXPECT_EQ(20, *table.Find("const1"));
+    EXPECT_EQ(nullptr, table.Find("nonexistent_key"));
+
+    EXPECT_FALSE(table.IsConstant("var1"));
+    EXPECT_TRUE(table.IsConstant("const1"));
+    EXPECT_THROW(table.IsConstant("nonexistent_key"), std::out_of_range);
+
+    EXPECT_EQ(10, table["var1"]);
+    EXPECT_THROW(table["const1"], std::runtime_error);
+    EXPECT_THROW(table["nonexistent_key"], std::out_of_range);
+    const auto& const_table = table;
+    EXPECT_EQ(20, const_table["const1"]);
+}
+
+TEST(THashTableOpenTest, grows_and_keeps_all_keys) {
+    THashTableOpen<std::string, int> table;
+    size_t initialCapacity = table.capacity();
+    const int count = 1000;
+    for (int i = 0; i < count; ++i)
+        ASSERT_TRUE(table.Insert("name" + std::to_string(i), i, i % 3 == 0));
+
+    EXPECT_EQ(count, table.size());
+    EXPECT_GT(table.capacity(), initialCapacity);
+    EXPECT_LE(table.size(), table.capacity() * 0.85);
+    for (int i = 0; i < count; ++i) {
+        const int* value = table.Find("name" + std::to_string(i));
+        ASSERT_NE(nullptr, value);
+        EXPECT_EQ(i, *value);
+        EXPECT_EQ(i % 3 == 0, table.IsConstant("name" + std::to_string(i)));
+    }
+}
+
+TEST(THashTableOpenTest, delete_keeps_colliding_keys_reachable) {
+    THashTableOpen<int, int> table;
+    // ,  ,         (hash<int> - 
+    //   ),    
+    size_t capacity = table.capacity();
+    for (int i = 0; i < 8; ++i)
+        table.Insert(static_cast<int>(i * capacity), i, false);
+
+    table.Delete(0);
+    table.Delete(static_cast<int>(3 * capacity));
+    table.Delete(12345); //      
+
+    EXPECT_EQ(6, table.size());
+    EXPECT_EQ(nullptr, table.Find(0));
+    EXPECT_EQ(nullptr, table.Find(static_cast<int>(3 * capacity)));
+    for (int i : { 1, 2, 4, 5, 6, 7 }) {
+        const int* value = table.Find(static_cast<int>(i * capacity));
+        ASSERT_NE(nullptr, value);
+        EXPECT_EQ(i, *value);
+    }
+
+    //   
+    EXPECT_TRUE(table.Insert(0, 100, true));
+    EXPECT_EQ(100, *table.Find(0));
+    EXPECT_EQ(7, table.size());
+}
+
+TEST(TableManagerTest, OpenTableManagerBehavesLikeChained) {
+    OpenTableManager manager;
+    EXPECT_TRUE(manager.addInt("x", 10, false));
+    EXPECT_TRUE(manager.addDouble("y", 1.5, true));
+    EXPECT_FALSE(manager.addDouble("x", 2.0, false));
+
+    EXPECT_EQ(manager.getInt("x"), 10);
+    EXPECT_DOUBLE_EQ(manager.getDoubleConst("y"), 1.5);
+    EXPECT_THROW(manager.getDouble("y"), std::runtime_error);
+    EXPECT_THROW(manager.getInt("y"), std::out_of_range);
+    EXPECT_TRUE(manager.isConstant("y"));
+    EXPECT_THROW(manager.isConstant("z"), std::out_of_range);
+    EXPECT_EQ(manager.findSlot("y"), 1);
+}
+
+// ---   TTableManager    - ---
+
+template <typename TManager>
+class TableManagerTypedTest : public ::testing::Test
+{
+protected:
+    TManager manager;
+};
+
+typedef ::testing::Types<TableManager, OpenTableManager> TableManagerImplementations;
+TYPED_TEST_CASE(TableManagerTypedTest, TableManagerImplementations);
+
+TYPED_TEST(TableManagerTypedTest, RedeclarationIsRejectedForAnyTypeAndKind) {
+    auto& manager = this->manager;
+    EXPECT_TRUE(manager.addInt("n", 1, false));
+    EXPECT_TRUE(manager.addDouble("d", 2.5, true));
+
+    //        ;   
+    EXPECT_FALSE(manager.addInt("n", 7, true));
+    EXPECT_FALSE(manager.addDouble("n", 7.5, false));
+    EXPECT_FALSE(manager.addInt("d", 3, false));
+    EXPECT_FALSE(manager.addDouble("d", 9.5, true));
+
+    EXPECT_EQ(manager.slotCount(), 2u);
+    EXPECT_EQ(manager.getIntConst("n"), 1);
+    EXPECT_FALSE(manager.isConstant("n"));
+    EXPECT_DOUBLE_EQ(manager.getDoubleConst("d"), 2.5);
+    EXPECT_TRUE(manager.isConstant("d"));
+    EXPECT_TRUE(manager.hasInt("n"));
+    EXPECT_FALSE(manager.hasDouble("n"));
+}
+
+TYPED_TEST(TableManagerTypedTest, ConstantFlagsGuardWritableAccess) {
+    auto& manager = this->manager;
+    manager.addInt("ci", 5, true);
+    manager.addDouble("cd", 0.5, true);
+    manager.addInt("vi", 6, false);
+
+    EXPECT_TRUE(manager.isConstant("ci"));
+    EXPECT_TRUE(manager.isConstant("cd"));
+    EXPECT_FALSE(manager.isConstant("vi"));
+    EXPECT_TRUE(manager.lookup("ci")->isConstant);
+    EXPECT_TRUE(manager.symbol(manager.findSlot("cd")).isConstant);
+    EXPECT_FALSE(manager.symbol(manager.findSlot("vi")).isConstant);
+
+    //      ,  
+    EXPECT_THROW(manager.getInt("ci"), std::runtime_error);
+    EXPECT_THROW(manager.getDouble("cd"), std::runtime_error);
+    EXPECT_EQ(manager.getIntConst("ci"), 5);
+    EXPECT_DOUBLE_EQ(manager.getDoubleConst("cd"), 0.5);
+    manager.getInt("vi") = 60;
+    EXPECT_EQ(manager.getIntConst("vi"), 60);
+}
+
+TYPED_TEST(TableManagerTypedTest, SlotReadsAndWritesMatchNamedAccess) {
+    auto& manager = this->manager;
+    //  ,      ,    
+    const int count = 200;
+    for (int i = 0; i < count; ++i) {
+        string name = "v" + std::to_string(i);
+        if (i % 2 == 0)
+            ASSERT_TRUE(manager.addInt(name, i, false));
+        else
+            ASSERT_TRUE(manager.addDouble(name, i + 0.25, false));
+    }
+
+    EXPECT_EQ(manager.slotCount(), static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        string name = "v" + std::to_string(i);
+        int slot = manager.findSlot(name);
+        ASSERT_EQ(slot, i); //  ,   
+        EXPECT_EQ(manager.lookup(name), &manager.symbol(slot));
+        EXPECT_DOUBLE_EQ(manager.readSlot(slot), i % 2 == 0 ? i : i + 0.25);
+    }
+
+    //           
+    manager.writeSlot(0, 9.75);
+    EXPECT_EQ(manager.getIntConst("v0"), 9);
+    manager.writeSlot(2, Value::real(-3.9));
+    EXPECT_EQ(manager.getIntConst("v2"), -3);
+    manager.writeSlot(4, Value::integer(3000000000LL)); //   int,   
+    EXPECT_EQ(manager.getIntConst("v4"), static_cast<int>(3000000000LL));
+    manager.writeSlot(1, Value::integer(7));
+    EXPECT_DOUBLE_EQ(manager.getDoubleConst("v1"), 7.0);
+    manager.writeSlot(3, 1.5);
+    EXPECT_DOUBLE_EQ(manager.getDoubleConst("v3"), 1.5);
+
+    //  :      
+    manager.getDouble("v199") = 0.125;
+    EXPECT_DOUBLE_EQ(manager.readSlot(199), 0.125);
+    EXPECT_EQ(manager.findSlot("v200"), -1);
+    EXPECT_EQ(manager.lookup("v200"), nullptr);
+}
@@ -0,0 +1,297 @@
+﻿#include "gtest.h"
+#include "transpiler.h"
+#include "program_executor.h"
+#include "parser.h"
+#include "lexer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace
+{
+    string translateProgram(const string& source)
+    {
+        Lexer lexer;
+        vector<Lexeme> lexemes = lexer.Tokenize(source);
+        Parser parser;
+        HLNode* tree = parser.BuildHList(lexemes);
+        string code;
+        try {
+            CppTranspiler transpiler;
+            code = transpiler.Translate(tree);
+        }
+        catch (...) {
+            delete tree;
+            throw;
+        }
+        delete tree;
+        return code;
+    }
+
+    void expectContains(const string& code, const string& fragment)
+    {
+        EXPECT_NE(code.find(fragment), string::npos) << "missing: " << fragment;
+    }
+}
+
+TEST(TranspilerTest, declarations_become_typed_locals_and_constants_are_inlined)
+{
+    string code = translateProgram(R"(
+    program Decl;
+    const
+        K : integer = 3;
+        Half = 0.5;
+    var
+        a, b : integer;
+        x : double;
+    begin
+        a := K * 2;
+        x := Half + a;
+        b := x;
+    end.)");
+
+    expectContains(code, "int v_a = 0;");
+    expectContains(code, "int v_b = 0;");
+    expectContains(code, "double v_x = 0.0;");
+    // Константы не становятся переменными: значение подставлено в выражение
+    EXPECT_EQ(code.find("v_k"), string::npos);
+    expectContains(code, "rt::mul(3LL, 2LL)");
+    expectContains(code, "0.5 + static_cast<double>(v_a)");
+    // Присваивание integer-переменной усекает значение, как TableManager::writeSlot
+    expectContains(code, "v_b = static_cast<int>(static_cast<long long>(v_x));");
+}
+
+TEST(TranspilerTest, if_else_and_io_become_native_code)
+{
+    string code = translateProgram(R"(
+    program Io;
+    var
+        a : integer;
+    begin
+        Read(a);
+        if a mod 2 = 0 then
+            begin
+            Write("even", a div 2);
+            end
+        else
+            Write("odd");
+    end.)");
+
+    expectContains(code, "v_a = static_cast<int>(rt::read(\"a\"));");
+    expectContains(code, "rt::intMod(v_a, 2LL)");
+    expectContains(code, "!= 0.0) {");
+    expectContains(code, "else {");
+    expectContains(code, "rt::write(\"even\", 4);");
+    expectContains(code, "rt::intDiv(v_a, 2LL)");
+    expectContains(code, "rt::write(\"odd\", 3);");
+}
+
+TEST(TranspilerTest, runtime_errors_are_emitted_at_their_node)
+{
+    string code = translateProgram(R"(
+    program Errors;
+    const
+        C = 1;
+    var
+        a : integer;
+    begin
+        Write("before");
+        C := 2;
+        a := missing + 1;
+    end.)");
+
+    expectContains(code, "rt::fail(\"Attempt to assign to constant: 'c'\");");
+    expectContains(code, "rt::fail(\"Identifier 'missing' isn't declared.\");");
+    EXPECT_LT(code.find("rt::write(\"before\""), code.find("rt::fail("));
+}
+
+TEST(TranspilerTest, declaration_errors_are_reported_at_translation_time)
+{
+    EXPECT_THROW(translateProgram("program P; var x : integer; x : double; begin end."), runtime_error);
+    EXPECT_THROW(translateProgram("program P; var x : integer;"), runtime_error);
+}
+
+TEST(TranspilerTest, string_literals_are_escaped)
+{
+    EXPECT_EQ(CppStringLiteral("a\"b\\c\n"), "\"a\\\"b\\\\c\\n\"");
+    EXPECT_EQ(CppStringLiteral("?\?="), "\"\\?\\?=\"");
+    EXPECT_EQ(CppStringLiteral("\xD0\x94" "1"), "\"\\320\\2241\"");
+}
+
+#if defined(PASCAL_TEST_CXX_COMPILER) && !defined(_WIN32)
+
+namespace
+{
+    struct ProcessResult
+    {
+        string output;
+        string error;
+        int exitCode = -1;
+    };
+
+    string readFile(const string& path)
+    {
+        ifstream in(path, ios::binary);
+        return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+
+    // Транслирует программу, собирает ее системным компилятором и запускает с заданным вводом
+    // (из файла, как при пакетном запуске) и параметрами командной строки
+    ProcessResult compileAndRun(const string& name, const string& source, const string& input,
+        const string& arguments = "")
+    {
+        const string base = "transpiler_test_" + name;
+        {
+            ofstream(base + ".cpp", ios::binary) << translateProgram(source);
+            ofstream(base + ".in", ios::binary) << input;
+        }
+
+        ProcessResult result;
+        string build = string("\"") + PASCAL_TEST_CXX_COMPILER + "\" -std=c++17 -O1 -o " + base + " " + base + ".cpp";
+        if (system(build.c_str()) != 0) {
+            ADD_FAILURE() << "generated code does not compile: " << base << ".cpp";
+            return result;
+        }
+
+        string run = "./" + base + " " + arguments + " < " + base + ".in > " + base + ".out 2> " + base + ".err";
+        int status = system(run.c_str());
+        result.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        result.output = readFile(base + ".out");
+        result.error = readFile(base + ".err");
+
+        for (const char* suffix : { ".cpp", ".in", ".out", ".err", "" })
+            remove((base + suffix).c_str());
+        return result;
+    }
+
+    // Интерпретатор так, как его запускает pascal с вводом не из терминала
+    ProcessResult interpret(const string& source, const string& input, bool prompts = false)
+    {
+        Lexer lexer;
+        vector<Lexeme> lexemes = lexer.Tokenize(source);
+        Parser parser;
+        HLNode* tree = parser.BuildHList(lexemes);
+
+        ostringstream out;
+        BufferInputSource in(input);
+        ProcessResult result;
+        try {
+            ProgramExecutor executor(out);
+            executor.setInput(in);
+            executor.setPrompts(prompts);
+            executor.Execute(tree);
+            result.exitCode = 0;
+        }
+        catch (const runtime_error& e) {
+            result.error = string("error: ") + e.what() + "\n";
+            result.exitCode = 1;
+        }
+        delete tree;
+        result.output = out.str();
+        return result;
+    }
+
+    void expectSameAsInterpreter(const string& name, const string& source, const string& input = "")
+    {
+        ProcessResult expected = interpret(source, input);
+        ProcessResult actual = compileAndRun(name, source, input);
+        EXPECT_EQ(actual.output, expected.output);
+        EXPECT_EQ(actual.error, expected.error);
+        EXPECT_EQ(actual.exitCode, expected.exitCode);
+    }
+}
+
+// Скомпилированная программа выводит то же, что интерпретатор: формат чисел, переполнение
+// integer по модулю 2^64, округление div/mod, усечение при присваивании, ветвления и Read
+TEST(TranspilerTest, compiled_program_matches_interpreter)
+{
+    expectSameAsInterpreter("arith", R"(
+    program Arith;
+    const
+        Big : integer = 2147483647;
+        Half = 0.5;
+    var
+        a, b, m, n : integer;
+        x, y : double;
+    begin
+        Read(a);
+        Read(x);
+        m := 0 - 1;
+        n := 0 - a;
+        b := Big * Big * Big;
+        Write(b, Big * Big, 9223372036854775807 + 1, a div 3, n div 3, n mod 3, a div m, a mod m);
+        y := x / 4 + Half;
+        Write(y, x div 0.75, x mod 0.7, a / 4, 0.00000015, 123456789.0, 0.1 + 0.2);
+        b := y * 1000;
+        a := x;
+        Write("b =", b, a, , "done");
+        if a > 2 then
+            begin
+            Write("big");
+            end
+        else
+            Write("small");
+        if b = 0 then
+            Write("zero");
+    end.)", "  17\n 3.75 ");
+}
+
+// Ошибка выполнения: накопленный вывод сохраняется, текст и код завершения - как у интерпретатора
+TEST(TranspilerTest, compiled_program_reports_interpreter_errors)
+{
+    const char* program = R"(
+    program Fail;
+    var
+        a, b : integer;
+        x : double;
+    begin
+        Read(a);
+        Write("a =", a);
+        x := a;
+        Write(x / b);
+    end.)";
+    expectSameAsInterpreter("div_zero", program, "5");
+    expectSameAsInterpreter("bad_input", program, "five");
+
+    expectSameAsInterpreter("int_div_zero", R"(
+    program Fail;
+    var
+        a, b : integer;
+    begin
+        a := 5;
+        Write(a mod 2);
+        a := a div b;
+        Write("unreachable");
+    end.)");
+}
+
+// Ввод из канала без параметров: как и pascal, программа не печатает приглашений;
+// --prompt включает их так же, как у интерпретатора
+TEST(TranspilerTest, compiled_program_prompts_like_interpreter)
+{
+    const char* program = R"(
+    program Echo;
+    var
+        n : integer;
+    begin
+        Read(n);
+        Write(n);
+    end.)";
+    ProcessResult piped = compileAndRun("piped", program, "42\n");
+    EXPECT_EQ(piped.output, "42\n");
+    EXPECT_EQ(piped.output, interpret(program, "42\n").output);
+    EXPECT_EQ(piped.exitCode, 0);
+
+    ProcessResult prompted = compileAndRun("prompted", program, "42\n", "--prompt");
+    EXPECT_EQ(prompted.output, "Enter value for n: 42\n");
+    EXPECT_EQ(prompted.output, interpret(program, "42\n", true).output);
+}
+
+#endif